@@ -1,20 +1,150 @@
 #include <Arduino.h>
-#include <Wire.h>
 #include "TMP117.h"
+#include "TMP117Convert.h"
+#include "TMP117SampleRing.h"
+#include "TMP117Trace.h"
 
-TMP117::TMP117(uint8_t addr, uint8_t alert_pin)
+TMP117 * TMP117::isr_instance[TMP117::ISR_INSTANCES];
+
+TMP117::TMP117(uint8_t addr, uint8_t alert_pin) : TMP117(transport_t::getDefault(),addr,alert_pin)
 {	// constructor
+}	// constructor
+
+TMP117::TMP117(transport_t & transport, uint8_t addr, uint8_t alert_pin) : transport(transport)
+{	// constructor(transport)
 	i2c_address=addr;
-	eeprom_state=EEPROM_START;
+	for (uint8_t n=0; n<TMP117_QUEUE_SIZE; n++)
+		queue[n].state=ENTRY_FREE;
+	queue_head=0;
+	queue_tail=0;
+	pointer_reg=POINTER_UNKNOWN;
+	eeprom_result=EEPROM_RESULT_IDLE;
+	eeprom_pending=0;
+	measure_deadline=0;
+	bus_ok=true;
+	resetHealth();
+	trace=NULL;
 	int_pin = alert_pin;
 	int_pin_active_high=false;
-}	// constructor
+	capture_ring=NULL;
+	capture_pending=false;
+	capture_overruns=0;
+	capture_failures=0;
+	configReg=SHADOW_CONFIG_RESET;
+	highLimit=SHADOW_HIGH_RESET;
+	lowLimit=SHADOW_LOW_RESET;
+	shadow_valid=false;
+	config_batch=false;
+	shadow_dirty=0;
+	status_latch=0;
+	// chip may still load EEPROM after power up
+	queue_transaction(TRANSACTION_EEPROM_WAIT,REG_CONFIGURATION,0,NULL,NULL);
+}	// constructor(transport)
 
-bool TMP117::init(void)				// test if chip exists and set int pin
+bool TMP117::init(void)				// test if chip exists, set int pin and load register shadow
 {	// init
+	bool exists=probe();
+	if (exists)
+		load_shadow();
+	return exists;
+}	// init
+
+bool TMP117::init(const profile_st & profile)	// as above, write profile instead of loading shadow
+{	// init(const profile_st & profile)
+	if (!probe())
+		return false;
+	// limits first, the configuration may start conversions
+	highLimit=profile.highLimit;
+	lowLimit=profile.lowLimit;
+	configReg=profile.config&~CONFIG_STATUS_MASK;
+	write_word(REG_HIGH_TEMP_LIMIT,highLimit);
+	write_word(REG_LOW_TEMP_LIMIT,lowLimit);
+	write_config();
+	shadow_valid=true;
+	config_batch=false;
+	shadow_dirty=0;
+	status_latch=0;
+	int_pin_active_high=(configReg&CONFIG_ALERT_POLARITY)!=0;
+	return true;
+}	// init(const profile_st & profile)
+
+bool TMP117::init(const profile_st & profile, uint8_t & changes, bool persist)	// warm start, read chip
+																				// state, write differences only
+{	// init(const profile_st & profile, uint8_t & changes, bool persist)
+	uint32_t start=millis();
+	uint16_t config;
+	uint16_t id=0;
+	uint16_t high=0;
+	uint16_t low=0;
+	uint16_t offset=0;
+	uint16_t signature=0;
+	changes=0;
+	if (!probe())
+		return false;
+	// registers are valid once the EEPROM is loaded after power up
+	do
+	{	// wait for EEPROM
+		config=read_config();
+		if (!bus_ok)
+			return false;
+	}	// wait for EEPROM
+	while ((config&CONFIG_EEPROM_BUSY) && ((uint16_t)(millis()-start)<=EEPROM_WRITE_DELAY));
+	if (config&CONFIG_EEPROM_BUSY)
+		return false;
+	drop_startup_wait();
+	if (	!read_word(REG_DEVICE_ID,id) || ((id&DEVICE_ID_MASK)!=DEVICE_ID) ||
+			!read_word(REG_HIGH_TEMP_LIMIT,high) || !read_word(REG_LOW_TEMP_LIMIT,low) ||
+			(profile.writeOffset && !read_word(REG_TEMP_OFFSET,offset)) || 
+			(persist && !read_word(REG_EEPROM_3,signature)))
+		return false;
+	
+	// limits first, the configuration may start conversions
+	highLimit=profile.highLimit;
+	lowLimit=profile.lowLimit;
+	configReg=profile.config&~CONFIG_STATUS_MASK;
+	if ((int16_t)high!=highLimit)
+	{	// high limit differs
+		write_word(REG_HIGH_TEMP_LIMIT,highLimit);
+		changes|=CHANGED_HIGH_LIMIT;
+	}	// high limit differs
+	if ((int16_t)low!=lowLimit)
+	{	// low limit differs
+		write_word(REG_LOW_TEMP_LIMIT,lowLimit);
+		changes|=CHANGED_LOW_LIMIT;
+	}	// low limit differs
+	if (profile.writeOffset && ((int16_t)offset!=profile.offset))
+	{	// offset differs, EEPROM locked: register only
+		write_word(REG_TEMP_OFFSET,profile.offset);
+		changes|=CHANGED_OFFSET;
+	}	// offset differs
+	if ((config&~CONFIG_STATUS_MASK)!=configReg)
+	{	// configuration differs
+		write_config();
+		changes|=CHANGED_CONFIG;
+	}	// configuration differs
+	shadow_valid=true;
+	config_batch=false;
+	shadow_dirty=0;
+	int_pin_active_high=(configReg&CONFIG_ALERT_POLARITY)!=0;
+	if (!bus_ok)
+		return false;
+	
+	if (persist && (signature!=profile_signature(profile)))
+	{	// power up defaults differ from profile
+		if (!persist_profile(profile,profile_signature(profile)))
+			return false;
+		changes|=CHANGED_EEPROM;
+	}	// power up defaults differ from profile
+	return true;
+}	// init(const profile_st & profile, uint8_t & changes, bool persist)
+
+bool TMP117::probe(void)				// test if chip exists, set int pin
+{	// probe
 	bool exists;
-	Wire.beginTransmission(i2c_address);
-	exists=(!Wire.endTransmission());
+	uint32_t start=micros();
+	exists=transport.probe(i2c_address);
+	if (trace)
+		trace->record(start,i2c_address,POINTER_UNKNOWN,TMP117Trace::OP_PROBE,exists,0);
 	if (int_pin!=0xFF)
 	{	// int_pin available
 		if (exists)
@@ -28,34 +158,117 @@ bool TMP117::init(void)				// test if chip exists and set int pin
 		}	// no chip -> no pin	
 	}	// int_pin available
 	return exists;
-}	// init
+}	// probe
 
 bool TMP117::process_idle(void)
 {	// process
-	switch (eeprom_state)
-	{	// switch eeprom_state
-		case EEPROM_IDLE:
-			break;
-		case EEPROM_WRITE_WAIT:
-			// delay required time before proceeding
-			if ((uint16_t)(millis()-time)>EEPROM_WRITE_DELAY)
-				eeprom_state=EEPROM_WRITE_BUSY;
-			break;
-		case EEPROM_WRITE_BUSY:
-		case EEPROM_START:
-			// EEPROM Flag in configuration register will be
-			// high during reset and write operation
-			configReg.RegisterData=read_word(REG_CONFIGURATION);
-			if (!configReg.Flags.EEPROM_Busy)
-				eeprom_state=EEPROM_IDLE;
-			break;
-		default:
-			eeprom_state=EEPROM_IDLE;
-			break;
-	}	// switch eeprom_state
-	return eeprom_state==EEPROM_IDLE;
+	transaction_st & entry=queue[queue_head];
+	if (capture_ring && capture_pending)
+		// data ready interrupt has priority over queued transactions
+		capture_sample();
+	else if (entry.state==ENTRY_PENDING)
+	{	// advance oldest transaction
+		if (process_transaction(entry))
+		{	// finished
+			queue_head=(queue_head+1)%TMP117_QUEUE_SIZE;
+			if (entry.callback)
+			{	// deliver and release
+				entry.state=ENTRY_FREE;
+				entry.callback(*this,entry.reg,entry.data,entry.context);
+			}	// deliver and release
+			else
+				entry.state=(entry.keep)?(ENTRY_DONE):(ENTRY_FREE);
+		}	// finished
+	}	// advance oldest transaction
+	return queue[queue_head].state!=ENTRY_PENDING;
 }	// process
 
+uint8_t TMP117::queueRead(uint8_t reg, transaction_cb_t callback, void * context)
+{	// queueRead
+	return queue_transaction(TRANSACTION_READ,reg,0,callback,context,!callback);
+}	// queueRead
+
+uint8_t TMP117::queueWrite(uint8_t reg, uint16_t val, transaction_cb_t callback, void * context)
+{	// queueWrite
+	return queue_transaction(TRANSACTION_WRITE,reg,val,callback,context,!callback);
+}	// queueWrite
+
+uint8_t TMP117::requestMeasurement(transaction_cb_t callback, void * context)	// start one-shot, temperature 
+																				// read once after deadline
+{	// requestMeasurement
+	uint8_t handle;
+	uint32_t deadline;
+	if (!queue_free())
+		return TRANSACTION_INVALID;
+	if (shadow_valid || load_shadow())
+	{	// trigger now, independent of batch mode
+		configReg=(configReg&~CONFIG_MODE_MASK)|((uint16_t)MODE_ONE_SHOT<<CONFIG_MODE_SHIFT);
+		shadow_dirty&=~SHADOW_CONFIGURATION;
+		write_config();
+	}	// trigger now
+	deadline=millis();
+	if (bus_ok)
+		deadline+=getMeasurementTime(getAveragingMode());
+	handle=queue_transaction(TRANSACTION_MEASURE,REG_TEMPERATURE,0,callback,context,!callback);
+	if (handle!=TRANSACTION_INVALID)
+	{	// full width, a poll later than half the 16 bit range still completes
+		queue[handle-1].deadline=deadline;
+		if (!bus_ok)
+			// no conversion started, the entry fails without reading an old result
+			queue[handle-1].ok=false;
+	}	// full width
+	measure_deadline=deadline;
+	return handle;
+}	// requestMeasurement
+
+uint32_t TMP117::getMeasurementDeadline(void)				// millis() when last requested result is read
+{	// getMeasurementDeadline
+	return measure_deadline;
+}	// getMeasurementDeadline
+
+bool TMP117::isTransactionDone(uint8_t handle)
+{	// isTransactionDone
+	return 	(handle!=TRANSACTION_INVALID) && (handle<=TMP117_QUEUE_SIZE) &&
+			(queue[handle-1].state==ENTRY_DONE);
+}	// isTransactionDone
+
+bool TMP117::getTransactionResult(uint8_t handle, uint16_t & data)
+{	// getTransactionResult
+	bool done=isTransactionDone(handle);
+	if (done)
+	{	// fetch and release
+		data=queue[handle-1].data;
+		queue[handle-1].state=ENTRY_FREE;
+		done=queue[handle-1].ok;
+	}	// fetch and release
+	return done;
+}	// getTransactionResult
+
+bool TMP117::isBusOk(void)						// last bus operation succeeded
+{	// isBusOk
+	return bus_ok;
+}	// isBusOk
+
+const TMP117::health_st & TMP117::getHealth(void)	// bus error counters
+{	// getHealth
+	return health;
+}	// getHealth
+
+void TMP117::resetHealth(void)
+{	// resetHealth
+	health.transfers=0;
+	health.nacks=0;
+	health.retries=0;
+	health.recoveries=0;
+	health.failures=0;
+	health.worstLatency=0;
+}	// resetHealth
+
+void TMP117::setTrace(TMP117Trace * trace)		// record bus operations, NULL stops recording
+{	// setTrace
+	this->trace=trace;
+}	// setTrace
+
 bool TMP117::isAlert(void)				// test Alert Pin
 {	// isAlert
 	bool bAlert=false;
@@ -65,16 +278,73 @@ bool TMP117::isAlert(void)				// test Alert Pin
 		bAlert=(int_pin_active_high)?(bAlert):(!bAlert);
 	}	// pin exists
 	else
-	{	// read config register
-		configReg.RegisterData=read_word(REG_CONFIGURATION);
-		bAlert=	(configReg.Flags.AlertMode) ? 
-				(configReg.Flags.DataReady) :
-				(configReg.Flags.highTempAlert || configReg.Flags.lowTempAlert);
-	}	// read config register
+	{	// latched flags or config register
+		if (!shadow_valid) load_shadow();
+		bAlert=	(configReg&CONFIG_ALERT_PIN_SELECT) ? 
+				(read_status(STATUS_DATA_READY)&STATUS_DATA_READY) :
+				(read_status(STATUS_HIGH_ALERT|STATUS_LOW_ALERT)&(STATUS_HIGH_ALERT|STATUS_LOW_ALERT));
+	}	// latched flags or config register
 	return bAlert;
 }	// isAlert
 
 
+bool TMP117::enableDataReadyCapture(TMP117SampleRing & ring)	// capture samples on data ready interrupt
+{	// enableDataReadyCapture
+	static void (* const isr[ISR_INSTANCES])(void)={isr_0,isr_1,isr_2,isr_3};
+	uint8_t slot=0;
+	
+	if ((int_pin==0xFF) || (digitalPinToInterrupt(int_pin)<0))
+		return false;
+	if (capture_ring)
+		disableDataReadyCapture();
+	while ((slot<ISR_INSTANCES) && isr_instance[slot])
+		slot++;
+	if (slot>=ISR_INSTANCES)
+		return false;
+		
+	setAlertPinSource(ALERT_PIN_DATA_READY);
+	int_pin_active_high=getAlertPinPolarity()==ALERT_PIN_ACTIVE_HIGH;
+	
+	capture_slot=slot;
+	capture_ring=&ring;
+	capture_overruns=0;
+	capture_failures=0;
+	capture_pending=false;
+	isr_instance[slot]=this;
+	attachInterrupt(digitalPinToInterrupt(int_pin),isr[slot],(int_pin_active_high)?(RISING):(FALLING));
+	if (isAlert())
+	{	// pin already active, no edge will follow before the result is read
+		capture_time=millis();
+		capture_pending=true;
+	}	// pin already active
+	return true;
+}	// enableDataReadyCapture
+
+void TMP117::disableDataReadyCapture(void)
+{	// disableDataReadyCapture
+	if (capture_ring)
+	{	// release interrupt
+		detachInterrupt(digitalPinToInterrupt(int_pin));
+		isr_instance[capture_slot]=NULL;
+		capture_ring=NULL;
+		capture_pending=false;
+	}	// release interrupt
+}	// disableDataReadyCapture
+
+uint16_t TMP117::getCaptureOverruns(void)					// samples lost since enable
+{	// getCaptureOverruns
+	uint16_t overruns;
+	noInterrupts();
+	overruns=capture_overruns;
+	interrupts();
+	return overruns;
+}	// getCaptureOverruns
+
+uint16_t TMP117::getCaptureFailures(void)					// failed reads since enable, retried
+{	// getCaptureFailures
+	return capture_failures;
+}	// getCaptureFailures
+
 int16_t TMP117::getTemp(uint8_t decimals)	// gets temperature in decimal fixed point notation
 {	// getTemp(uint8_t decimals)
 	return convertToDec(getTemp(),decimals);
@@ -82,7 +352,12 @@ int16_t TMP117::getTemp(uint8_t decimals)	// gets temperature in decimal fixed p
 
 int16_t TMP117::getTemp(void)				// gets temperature in binary s8.7 fixed point notiation
 {	// getTemp(void)
-	return read_word(REG_TEMPERATURE);
+	// reading the result clears data ready on the chip, a failed read keeps it latched
+	uint16_t temp;
+	if (!read_word(REG_TEMPERATURE,temp))
+		return INT16_MIN;
+	status_latch&=~STATUS_DATA_READY;
+	return (int16_t)temp;
 }	// getTemp(void)
 
 void TMP117::setHighTemperaturLimit(int16_t tempDec, uint8_t decimals)	// set value in decimal fixed point notation
@@ -92,7 +367,10 @@ void TMP117::setHighTemperaturLimit(int16_t tempDec, uint8_t decimals)	// set va
 
 void TMP117::setHighTemperaturLimit(int16_t tempIQ)					// set value in binary s8.7 fixed point notation
 {	//	setHighTemperaturLimit(int16_t tempIQ)
-	write_word(REG_HIGH_TEMP_LIMIT,tempIQ);
+	if (!shadow_valid && !load_shadow())
+		return;
+	highLimit=tempIQ;
+	update_register(SHADOW_HIGH_LIMIT);
 }	//	setHighTemperaturLimit(int16_t tempIQ)
 
 void TMP117::setLowTemperaturLimit(int16_t tempDec, uint8_t decimals)	// set value in decimal fixed point notation
@@ -102,7 +380,10 @@ void TMP117::setLowTemperaturLimit(int16_t tempDec, uint8_t decimals)	// set val
 
 void TMP117::setLowTemperaturLimit(int16_t tempIQ)					// set value in binary s8.7 fixed point notation
 {	//	setHighTemperaturLimit(int16_t tempIQ)
-	write_word(REG_LOW_TEMP_LIMIT,tempIQ);
+	if (!shadow_valid && !load_shadow())
+		return;
+	lowLimit=tempIQ;
+	update_register(SHADOW_LOW_LIMIT);
 }	//	setHighTemperaturLimit(int16_t tempIQ)
 
 int16_t TMP117::getHighTemperaturLimit(uint8_t decimals)	// get value in decimal fixed point notation
@@ -112,7 +393,8 @@ int16_t TMP117::getHighTemperaturLimit(uint8_t decimals)	// get value in decimal
 
 int16_t TMP117::getHighTemperaturLimit(void)				// get value in binary s8.7 fixed point notation 
 {	// getHighTemperaturLimit(void)
-	return read_word(REG_HIGH_TEMP_LIMIT);
+	if (!shadow_valid) load_shadow();
+	return highLimit;
 }	// getHighTemperaturLimit(void)
 
 int16_t TMP117::getLowTemperaturLimit(uint8_t decimals)		// get value in decimal fixed point notation
@@ -122,166 +404,251 @@ int16_t TMP117::getLowTemperaturLimit(uint8_t decimals)		// get value in decimal
 
 int16_t TMP117::getLowTemperaturLimit(void)                 // get value in binary s8.7 fixed point notation
 {	// getLowTemperaturLimit(void)
-	return read_word(REG_LOW_TEMP_LIMIT);
+	if (!shadow_valid) load_shadow();
+	return lowLimit;
 }	// getLowTemperaturLimit(void)
 
 uint16_t TMP117::getDeviceID(void)
 {	// getDeviceID
-	deviceID_ut deviceID;
-	deviceID.RegisterData=read_word(REG_DEVICE_ID);
-	return deviceID.Flags.ID;
+	return read_word(REG_DEVICE_ID)&DEVICE_ID_MASK;
 }	// getDeviceID
 
 uint8_t TMP117::getDeviceRevision(void)
 {	// getDeviceRevision
-	deviceID_ut deviceID;
-	deviceID.RegisterData=read_word(REG_DEVICE_ID);
-	return deviceID.Flags.Rev;
+	return read_word(REG_DEVICE_ID)>>DEVICE_REV_SHIFT;
 }	// getDeviceRevision
 
 
 void TMP117::reset(void)
 {	// reset
-	configReg.RegisterData=read_word(REG_CONFIGURATION);
-	configReg.Flags.SoftReset=true;
-	write_word(REG_CONFIGURATION,configReg.RegisterData);
-	eeprom_state=EEPROM_START;
+	// the reset bit is the only one evaluated, the chip
+	// reloads all other bits from EEPROM
+	write_word(REG_CONFIGURATION,CONFIG_SOFT_RESET);
+	shadow_valid=false;
+	shadow_dirty=0;
+	pointer_reg=POINTER_UNKNOWN;
+	queue_transaction(TRANSACTION_EEPROM_WAIT,REG_CONFIGURATION,0,NULL,NULL);
 }	// reset
 
 void TMP117::setAlertPinSource(alert_pin_select_et source)
 {	// setAlertPinSource
-	configReg.RegisterData=read_word(REG_CONFIGURATION);
-	configReg.Flags.AlertPinSelect=source==ALERT_PIN_DATA_READY;
-	write_word(REG_CONFIGURATION,configReg.RegisterData);
+	set_config(CONFIG_ALERT_PIN_SELECT,(source==ALERT_PIN_DATA_READY)?(CONFIG_ALERT_PIN_SELECT):(0));
 } 	// setAlertPinSource
 
 void TMP117::setAlertPinPolarity(alert_pin_polarity_et polarity)
 {	// setAlertPinPolarity
-	configReg.RegisterData=read_word(REG_CONFIGURATION);
-	configReg.Flags.AlertPinPolarity=polarity==ALERT_PIN_ACTIVE_HIGH;
-	write_word(REG_CONFIGURATION,configReg.RegisterData);
+	set_config(CONFIG_ALERT_POLARITY,(polarity==ALERT_PIN_ACTIVE_HIGH)?(CONFIG_ALERT_POLARITY):(0));
 	int_pin_active_high=polarity==ALERT_PIN_ACTIVE_HIGH;
 }	// setAlertPinPolarity
 
 void TMP117::setAlertMode(alert_mode_select_et mode)
 {	// setAlertMode
-	configReg.RegisterData=read_word(REG_CONFIGURATION);
-	configReg.Flags.AlertMode=mode==ALERT_MODE_ALERT;
-	write_word(REG_CONFIGURATION,configReg.RegisterData);
+	// T/nA bit: 1=therm, 0=alert
+	set_config(CONFIG_ALERT_MODE,(mode==ALERT_MODE_THERMISTOR)?(CONFIG_ALERT_MODE):(0));
 }	// setAlertMode
 
 void TMP117::setAveragingMode(averaging_mode_et mode)
 {	// setAveragingMode
-	configReg.RegisterData=read_word(REG_CONFIGURATION);
-	configReg.Flags.AveragingMode=(uint8_t)mode;
-	write_word(REG_CONFIGURATION,configReg.RegisterData);
+	set_config(CONFIG_AVERAGING_MASK,(uint16_t)mode<<CONFIG_AVERAGING_SHIFT);
 }	// setAveragingMode
 
 void TMP117::setConversionTime(conversion_time_et time)
 {	// setConversionTime
-	configReg.RegisterData=read_word(REG_CONFIGURATION);
-	configReg.Flags.ConversionCycleTime=(uint8_t)time;
-	write_word(REG_CONFIGURATION,configReg.RegisterData);
+	set_config(CONFIG_CONVERSION_MASK,(uint16_t)time<<CONFIG_CONVERSION_SHIFT);
 }	// setConversionTime
 
 void TMP117::setConversionMode(conversion_mode_et mode)
 {	// setConversionMode
-	configReg.RegisterData=read_word(REG_CONFIGURATION);
-	configReg.Flags.ConversionMode=(uint8_t)mode;
-	write_word(REG_CONFIGURATION,configReg.RegisterData);
+	set_config(CONFIG_MODE_MASK,(uint16_t)mode<<CONFIG_MODE_SHIFT);
 }	// setConversionMode
 
 
-TMP117::alert_mode_select_et 	TMP117::getAlertPinSource(void)
+TMP117::alert_pin_select_et 	TMP117::getAlertPinSource(void)
 {	// getAlertPinSource
-	configReg.RegisterData=read_word(REG_CONFIGURATION);
-	return (alert_mode_select_et)configReg.Flags.AlertPinSelect;
+	return (get_config(CONFIG_ALERT_PIN_SELECT))?(ALERT_PIN_DATA_READY):(ALERT_PIN_ALERT);
 }	// getAlertPinSource
 
+void TMP117::beginConfig(void)
+{	// beginConfig
+	if (!shadow_valid) load_shadow();
+	config_batch=true;
+}	// beginConfig
+
+void TMP117::commitConfig(void)
+{	// commitConfig
+	config_batch=false;
+	if (shadow_dirty&SHADOW_CONFIGURATION)
+		write_config();
+	if (shadow_dirty&SHADOW_HIGH_LIMIT)
+		write_word(REG_HIGH_TEMP_LIMIT,highLimit);
+	if (shadow_dirty&SHADOW_LOW_LIMIT)
+		write_word(REG_LOW_TEMP_LIMIT,lowLimit);
+	shadow_dirty=0;
+}	// commitConfig
+
 TMP117::alert_pin_polarity_et 	TMP117::getAlertPinPolarity(void)
 {	// getAlertPinPolarity
-	configReg.RegisterData=read_word(REG_CONFIGURATION);
-	return (alert_pin_polarity_et)configReg.Flags.AlertPinPolarity;
+	return (get_config(CONFIG_ALERT_POLARITY))?(ALERT_PIN_ACTIVE_HIGH):(ALERT_PIN_ACTIVE_LOW);
 }	// getAlertPinPolarity
 
 TMP117::alert_mode_select_et 	TMP117::getAlertMode(void)
 {	// getAlertMode
-	configReg.RegisterData=read_word(REG_CONFIGURATION);
-	return (alert_mode_select_et)configReg.Flags.AlertMode;
+	return (get_config(CONFIG_ALERT_MODE))?(ALERT_MODE_THERMISTOR):(ALERT_MODE_ALERT);
 }	// getAlertMode
 
 TMP117::averaging_mode_et		TMP117::getAveragingMode(void)
 {	// getAveragingMode
-	configReg.RegisterData=read_word(REG_CONFIGURATION);
-	return (averaging_mode_et)configReg.Flags.AveragingMode;
+	return (averaging_mode_et)(get_config(CONFIG_AVERAGING_MASK)>>CONFIG_AVERAGING_SHIFT);
 }	// getAveragingMode
 
 TMP117::conversion_time_et		TMP117::getConversionTime(void)
 {	// getConversionTime
-	configReg.RegisterData=read_word(REG_CONFIGURATION);
-	return (conversion_time_et)configReg.Flags.ConversionCycleTime;
+	return (conversion_time_et)(get_config(CONFIG_CONVERSION_MASK)>>CONFIG_CONVERSION_SHIFT);
 }	// getConversionTime
 
 TMP117::conversion_mode_et		TMP117::getConversionMode(void)
 {	// getConversionMode
-	configReg.RegisterData=read_word(REG_CONFIGURATION);
-	return (conversion_mode_et)configReg.Flags.ConversionMode;
+	uint8_t mode=(get_config(CONFIG_MODE_MASK)>>CONFIG_MODE_SHIFT);
+	if (mode==MODE_CONTINUOUS_RES)
+		return MODE_CONTINUOUS;		// chip reads back 00 
+	return (conversion_mode_et)mode;
 }	// getConversionMode
 
+uint16_t TMP117::getConversionDuration(averaging_mode_et mode)	// active conversion time in ms
+{	// getConversionDuration
+	static const uint16_t duration[]={16,125,500,1000};	// 15.5ms without averaging
+	return duration[mode&0x03];
+}	// getConversionDuration
+
+uint16_t TMP117::getMeasurementTime(averaging_mode_et mode)		// one-shot conversion incl. tolerance in ms
+{	// getMeasurementTime
+	uint16_t duration=getConversionDuration(mode);
+	// the conversion time is typical, allow 12.5% and the tick of millis()
+	return duration+(duration>>3)+1;
+}	// getMeasurementTime
+
+uint16_t TMP117::getConversionCycleTime(conversion_time_et time, averaging_mode_et mode)
+{	// getConversionCycleTime(conversion_time_et time, averaging_mode_et mode)
+	static const uint16_t cycle[]={16,125,250,500,1000,4000,8000,16000};
+	uint16_t active=getConversionDuration(mode);
+	// cycle is stretched if averaging takes longer than the selected cycle time
+	return (cycle[time&0x07]>active)?(cycle[time&0x07]):(active);
+}	// getConversionCycleTime(conversion_time_et time, averaging_mode_et mode)
+
+uint16_t TMP117::getConversionCycleTime(void)					// time between results in continuous mode in ms
+{	// getConversionCycleTime(void)
+	return getConversionCycleTime(getConversionTime(),getAveragingMode());
+}	// getConversionCycleTime(void)
+
+uint32_t TMP117::getSupplyCurrent(conversion_time_et time, averaging_mode_et mode)	// average in continuous mode in nA
+{	// getSupplyCurrent
+	uint32_t active=getConversionDuration(mode);
+	uint32_t cycle=getConversionCycleTime(time,mode);
+	return (CURRENT_ACTIVE_NA*active+CURRENT_STANDBY_NA*(cycle-active))/cycle;
+}	// getSupplyCurrent
+
+TMP117::status_st TMP117::readStatus(bool readTemp)	// read flags once, temperature only if data ready
+{	// readStatus
+	status_st result;
+	result.eepromBusy=(read_config()&CONFIG_EEPROM_BUSY)!=0;
+	result.busOk=bus_ok;				// otherwise only previously latched flags
+	result.dataReady=(status_latch&STATUS_DATA_READY)!=0;
+	result.highAlert=(status_latch&STATUS_HIGH_ALERT)!=0;
+	result.lowAlert=(status_latch&STATUS_LOW_ALERT)!=0;
+	result.tempValid=false;
+	result.temp=0;
+	if (readTemp && result.dataReady && result.busOk)
+	{	// new result
+		int16_t temp=getTemp();
+		result.tempValid=bus_ok;
+		result.busOk=bus_ok;
+		if (result.tempValid)
+			result.temp=temp;
+	}	// new result
+	return result;
+}	// readStatus
+
+void TMP117::clearStatus(void)						// clear latched status flags
+{	// clearStatus
+	status_latch=0;
+}	// clearStatus
+
 bool TMP117::isDataReady(void)
 {	// isDataReady
-	configReg.RegisterData=read_word(REG_CONFIGURATION);
-	return configReg.Flags.DataReady;
+	return (read_status(STATUS_DATA_READY)&STATUS_DATA_READY)!=0;
 }	// isDataReady
 
 bool TMP117::testHighTemperatureAlert(void)
 {	// testHighTemperatureAlert
-	configReg.RegisterData=read_word(REG_CONFIGURATION);
-	return configReg.Flags.highTempAlert;
+	return (read_status(STATUS_HIGH_ALERT)&STATUS_HIGH_ALERT)!=0;
 }	// testHighTemperatureAlert
 
 bool TMP117::testLowTemperatureAlert(void)
 {	// testLowTemperatureAlert
-	configReg.RegisterData=read_word(REG_CONFIGURATION);
-	return configReg.Flags.lowTempAlert;
+	return (read_status(STATUS_LOW_ALERT)&STATUS_LOW_ALERT)!=0;
 }	// testLowTemperatureAlert
 
 bool TMP117::testEepromBusy(void)
 {	// testEepromBusy	
-	EEPROM_UnlockReg_ut unlockReg;
-	unlockReg.RegisterData=read_word(REG_EEPROM_UNLOCK);
-	return unlockReg.Flags.EEPROM_Busy;
+	return (read_word(REG_EEPROM_UNLOCK)&EEPROM_UNLOCK_BUSY)!=0;
 }	// testEepromBusy
 
 bool TMP117::testEepromLocked(void)
 {	// testEepromLocked
-	EEPROM_UnlockReg_ut unlockReg;
-	unlockReg.RegisterData=read_word(REG_EEPROM_UNLOCK);
-	return unlockReg.Flags.EUN;
+	return !(read_word(REG_EEPROM_UNLOCK)&EEPROM_UNLOCK_EUN);
 }	// testEepromLocked
 
 void TMP117::setEepromLockState(eeprom_lock_mode_et lock)
 {	// setEepromLockState
-	EEPROM_UnlockReg_ut unlockReg;
-	unlockReg.RegisterData=read_word(REG_EEPROM_UNLOCK);
-	unlockReg.Flags.EUN=lock==EEPROM_UNLOCK;
-	write_word(REG_EEPROM_UNLOCK,unlockReg.RegisterData);
+	// all other bits are read only
+	write_word(REG_EEPROM_UNLOCK,(lock==EEPROM_UNLOCK)?(EEPROM_UNLOCK_EUN):(0));
 }	// setEepromLockState
 
-void TMP117::writeEeprom(eeprom_pos_et Register, uint16_t val)
+bool TMP117::writeEeprom(eeprom_pos_et Register, uint16_t val)
 {	// writeEeprom(eeprom_pos_et Register, uint16_t val) 
-	write_word(REG_EEPROM_1+(uint8_t)Register,val);
-	eeprom_state=EEPROM_WRITE_WAIT;
+	bool queued=queue_transaction(	TRANSACTION_EEPROM_WRITE,REG_EEPROM_1+(uint8_t)Register,
+									val,eeprom_set_done,NULL)!=TRANSACTION_INVALID;
+	if (queued)
+	{	// new operation
+		if (!eeprom_pending++)
+			eeprom_result=EEPROM_RESULT_BUSY;
+	}	// new operation
+	return queued;
 }	// writeEeprom(eeprom_pos_et Register, uint16_t val)
 
-void TMP117::writeTemperatureOffset(int16_t val)
+bool TMP117::writeTemperatureOffset(int16_t val)
 {	// writeTemperatureOffset
-	writeEeprom(TEMPERATURE_OFFSET,(uint16_t) val);
+	return writeEeprom(TEMPERATURE_OFFSET,(uint16_t) val);
 }	// writeTemperatureOffset
 
+bool TMP117::writeEepromSet(const uint16_t val[4], uint8_t mask)	// unlock, write, verify and lock
+{	// writeEepromSet
+	uint8_t count=0;
+	for (uint8_t n=0; n<4; n++)
+		if (mask&(1<<n))
+			count++;
+	if (!count || (queue_free()<count+2))
+		return false;
+	
+	if (!eeprom_pending++)
+		eeprom_result=EEPROM_RESULT_BUSY;
+	queue_transaction(TRANSACTION_EEPROM_LOCK,REG_EEPROM_UNLOCK,EEPROM_UNLOCK_EUN,NULL,NULL);
+	for (uint8_t n=0; n<4; n++)
+		if (mask&(1<<n))
+			queue_transaction(TRANSACTION_EEPROM_WRITE,REG_EEPROM_1+n,val[n],NULL,NULL);
+	// lock completes the set
+	queue_transaction(TRANSACTION_EEPROM_LOCK,REG_EEPROM_UNLOCK,0,eeprom_set_done,NULL);
+	return true;
+}	// writeEepromSet
+
+TMP117::eeprom_result_et TMP117::getEepromResult(void)
+{	// getEepromResult
+	return eeprom_result;
+}	// getEepromResult
+
 uint16_t TMP117::readEeprom(eeprom_pos_et Register)
 {	// uint16_t readEeprom
-	return read_word(Register);
+	return read_word(REG_EEPROM_1+(uint8_t)Register);
 }	// uint16_t readEeprom
 
 int16_t TMP117::readTemperatureOffset(void)
@@ -299,55 +666,17 @@ int16_t TMP117::convertToIQ(int16_t valDec, uint8_t decimals)	// converts a valu
 																// to IQ 9.7 value
 																// 9.5°C given as (95,1) yields in 0x04C0	
 {	//	convertToIQ
-	/* valIQ=valDec/10^decimals*2^7
-	 * 		=valDec/5^decimals*2^(7-decimals)
-	 */
-	uint8_t shifts=7-decimals;
-	bool	overflow=false;
-
 	switch (decimals)
-	{	// check if overflow when converting
-		case 0:
-			overflow|=valDec>255;
-			overflow|=valDec<-256;
-			break;
-		case 1:
-			overflow|=valDec>2559;
-			overflow|=valDec<-2560;
-			break;
-		case 2:
-			overflow|=valDec>25599;
-			overflow|=valDec<-25600;
-			break;
+	{	// select kernel
+		case 0:	return TMP117Convert::toIQ<0>(valDec);
+		case 1:	return TMP117Convert::toIQ<1>(valDec);
+		case 2:	return TMP117Convert::toIQ<2>(valDec);
+		case 3:	return TMP117Convert::toIQ<3>(valDec);
+		case 4:	return TMP117Convert::toIQ<4>(valDec);
 		default:
-			overflow=true;
-	}	// check if overflow when converting
-	
-	if (!overflow)
-	{	// convert
-		while ((shifts>0) || (decimals>0))
-		{	// interchange leftshift and division to guarantee max precision
-			while ((valDec<INT16_MAX>>1) && (valDec>INT16_MIN>>1) && (shifts>0))
-			{	// shift while result ist less than Max
-				shifts--;
-				valDec<<=1;
-			}	// shift while result ist less than Max
-			if (decimals>0)
-			{	// divide
-				decimals--;
-				valDec/=5;
-			}	// divide
-		}	// interchange leftshift and division to guarantee max precision
-	}	// convert
-	else
-	{	// saturate
-		if (valDec>0)
-			valDec=INT16_MAX;
-		else
-			valDec=INT16_MIN;
-	}	// saturate
-	
-	return valDec;
+			// saturate
+			return (valDec>0)?(INT16_MAX):(INT16_MIN);
+	}	// select kernel
 }	//	convertToIQ
 
 int16_t TMP117::convertToDec(int16_t valIQ, uint8_t decimals)	// converts a value given as IQ 9.7 value to
@@ -355,51 +684,382 @@ int16_t TMP117::convertToDec(int16_t valIQ, uint8_t decimals)	// converts a valu
 																// 9,5°C given as IQ 9.7 equals 0x04C0 
 																// (0x04C0,1) yields in 95	 
 {	//	convertToDec
-	/* valDec=valIQ*10^decimals/2^7
-	 * 		 =valIQ*5^decimals/2^(7-decimals)
-	 */
-	uint8_t shifts=7-decimals;
-	
-	if (decimals>2)	valIQ=INT16_MAX;
-		
-	if ((valIQ!=INT16_MIN) && (valIQ!=INT16_MAX))
-	{	// convert
-		while ((shifts>0) || (decimals>0))
-		{	// interchange rightshift and multiplication to guarantee max precision
-			while ((valIQ<INT16_MAX/5) && (valIQ>INT16_MIN/5) && (decimals>0))
-			{	//  multiply while result ist less than Max
-				decimals--;
-				valIQ*=5;
-			}	// multiply  while result ist less than Max
-			if (shifts>0)
-			{	// shift, needs to be implemented als arithmetc shift
-				shifts--;
-				valIQ>>=1;
-			}	// shift, needs to be implemented als arithmetc shift
-		}	// interchange rightshift and multiplication to guarantee max precision
-	}	// convert
-	
-	return valIQ;
+	switch (decimals)
+	{	// select kernel
+		case 0:	return TMP117Convert::toDec<0>(valIQ);
+		case 1:	return TMP117Convert::toDec<1>(valIQ);
+		case 2:	return TMP117Convert::toDec<2>(valIQ);
+		case 3:	return TMP117Convert::toDec<3>(valIQ);
+		case 4:	return TMP117Convert::toDec<4>(valIQ);
+		default:
+			return INT16_MAX;
+	}	// select kernel
 }	//	convertToDec
 
-uint16_t TMP117::read_word(uint8_t reg)
-{	// read_word
-	uint16_t temp=0;
-	Wire.beginTransmission(i2c_address);
-	Wire.write(reg);
-	Wire.endTransmission(false);
-	Wire.requestFrom(i2c_address,2);
-	temp=(uint8_t)Wire.read();
-	temp<<=8;
-	temp|=(uint8_t)Wire.read();
-	return temp;
-}	// read_word
-
-void TMP117::write_word(uint8_t reg, uint16_t val)
+void TMP117_ISR_ATTR TMP117::isr_0(void)
+{	// isr_0
+	isr_instance[0]->data_ready_isr();
+}	// isr_0
+
+void TMP117_ISR_ATTR TMP117::isr_1(void)
+{	// isr_1
+	isr_instance[1]->data_ready_isr();
+}	// isr_1
+
+void TMP117_ISR_ATTR TMP117::isr_2(void)
+{	// isr_2
+	isr_instance[2]->data_ready_isr();
+}	// isr_2
+
+void TMP117_ISR_ATTR TMP117::isr_3(void)
+{	// isr_3
+	isr_instance[3]->data_ready_isr();
+}	// isr_3
+
+void TMP117_ISR_ATTR TMP117::data_ready_isr(void)
+{	// data_ready_isr
+	if (capture_pending)
+		// previous result not read in time
+		capture_overruns++;
+	capture_time=millis();
+	capture_pending=true;
+}	// data_ready_isr
+
+void TMP117::capture_sample(void)
+{	// capture_sample
+	sample_st sample;
+	noInterrupts();
+	sample.timestamp=capture_time;
+	capture_pending=false;
+	interrupts();
+	// reading the result releases the ALERT pin
+	sample.temp=getTemp();
+	if (!bus_ok)
+	{	// no sample, INT16_MIN is not a reading
+		capture_failures++;
+		if (isAlert())
+		{	// result still unread, no edge will follow, retry on next call
+			noInterrupts();
+			capture_pending=true;
+			interrupts();
+		}	// result still unread
+	}	// no sample
+	else if (!capture_ring->push(sample))
+	{	// ring full
+		noInterrupts();
+		capture_overruns++;
+		interrupts();
+	}	// ring full
+}	// capture_sample
+
+void TMP117::drop_startup_wait(void)			// EEPROM loaded, remove wait queued by constructor
+{	// drop_startup_wait
+	transaction_st & entry=queue[queue_head];
+	if (	(entry.state==ENTRY_PENDING) && (entry.type==TRANSACTION_EEPROM_WAIT) && 
+			!entry.callback && !entry.keep)
+	{	// release entry
+		entry.state=ENTRY_FREE;
+		queue_head=(queue_head+1)%TMP117_QUEUE_SIZE;
+	}	// release entry
+}	// drop_startup_wait
+
+bool TMP117::persist_profile(const profile_st & profile, uint16_t signature)	// queue EEPROM programming
+{	// persist_profile
+	static const uint8_t reg[]={REG_CONFIGURATION,REG_HIGH_TEMP_LIMIT,REG_LOW_TEMP_LIMIT,REG_TEMP_OFFSET,REG_EEPROM_3};
+	const uint16_t val[]={	(uint16_t)(profile.config&~CONFIG_STATUS_MASK),(uint16_t)profile.highLimit,
+							(uint16_t)profile.lowLimit,(uint16_t)profile.offset,signature};
+	if (queue_free()<sizeof(reg)+2)
+		return false;
+	if (!eeprom_pending++)
+		eeprom_result=EEPROM_RESULT_BUSY;
+	queue_transaction(TRANSACTION_EEPROM_LOCK,REG_EEPROM_UNLOCK,EEPROM_UNLOCK_EUN,NULL,NULL);
+	// signature last, an interrupted sequence is repeated on next start
+	for (uint8_t n=0; n<sizeof(reg); n++)
+		if ((reg[n]!=REG_TEMP_OFFSET) || profile.writeOffset)
+			queue_transaction(TRANSACTION_EEPROM_WRITE,reg[n],val[n],NULL,NULL);
+	queue_transaction(TRANSACTION_EEPROM_LOCK,REG_EEPROM_UNLOCK,0,eeprom_set_done,NULL);
+	return true;
+}	// persist_profile
+
+uint16_t TMP117::profile_signature(const profile_st & profile)	// stored in EEPROM_POS_3
+{	// profile_signature
+	const uint16_t val[]={	(uint16_t)(profile.config&~CONFIG_STATUS_MASK),(uint16_t)profile.highLimit,
+							(uint16_t)profile.lowLimit,(uint16_t)profile.offset};
+	uint16_t crc=0xFFFF;
+	// a kept offset is not part of the profile
+	for (uint8_t n=0; n<((profile.writeOffset)?(4):(3)); n++)
+		for (uint8_t bit=0; bit<16; bit++)
+			// CRC16-CCITT, MSB first
+			crc=(((crc^(val[n]<<bit))&0x8000))?((crc<<1)^0x1021):(crc<<1);
+	// erased / factory EEPROM reads 0
+	return (crc)?(crc):(0x0117);
+}	// profile_signature
+
+bool TMP117::load_shadow(void)				// read configuration and limits into shadow, false on bus error
+{	// load_shadow
+	uint16_t config;
+	uint16_t high;
+	uint16_t low;
+	// a partial read leaves the previous shadow content
+	shadow_valid=	read_word(REG_CONFIGURATION,config) && 
+					read_word(REG_HIGH_TEMP_LIMIT,high) &&
+					read_word(REG_LOW_TEMP_LIMIT,low);
+	if (shadow_valid)
+	{	// complete
+		configReg=config;
+		highLimit=high;
+		lowLimit=low;
+		shadow_dirty=0;
+	}	// complete
+	return shadow_valid;
+}	// load_shadow
+
+uint16_t TMP117::get_config(uint16_t mask)	// masked bits of configuration shadow
+{	// get_config
+	if (!shadow_valid) load_shadow();
+	return configReg&mask;
+}	// get_config
+
+void TMP117::set_config(uint16_t mask, uint16_t value)	// replace masked bits of configuration shadow
+{	// set_config
+	if (!shadow_valid && !load_shadow())
+		// the other bits are unknown, nothing is written
+		return;
+	configReg=(configReg&~mask)|(value&mask);
+	update_register(SHADOW_CONFIGURATION);
+}	// set_config
+
+void TMP117::update_register(uint8_t shadow)
+{	// update_register
+	if (config_batch)
+		shadow_dirty|=shadow;
+	else if (shadow==SHADOW_CONFIGURATION)
+		write_config();
+	else if (shadow==SHADOW_HIGH_LIMIT)
+		write_word(REG_HIGH_TEMP_LIMIT,highLimit);
+	else if (shadow==SHADOW_LOW_LIMIT)
+		write_word(REG_LOW_TEMP_LIMIT,lowLimit);
+}	// update_register
+
+void TMP117::write_config(void)
+{	// write_config
+	write_word(REG_CONFIGURATION,configReg&~CONFIG_STATUS_MASK);
+	if (((configReg&CONFIG_MODE_MASK)>>CONFIG_MODE_SHIFT)==MODE_ONE_SHOT)
+		// chip returns to shutdown after the conversion, 
+		// avoid triggering another one with the next write
+		configReg=(configReg&~CONFIG_MODE_MASK)|((uint16_t)MODE_SHUTDOWN<<CONFIG_MODE_SHIFT);
+}	// write_config
+
+uint16_t TMP117::read_config(void)				// read configuration register, latch status flags
+{	// read_config
+	// reading clears the status flags, keep them until they are
+	// cleared explicitly, config bits are kept in the shadow register
+	uint16_t val=read_word(REG_CONFIGURATION);	// 0 on bus error
+	status_latch|=val&STATUS_LATCH_MASK;
+	return val;
+}	// read_config
+
+uint16_t TMP117::read_status(uint16_t flags)		// latched flags, read chip if none of flags is latched
+{	// read_status
+	if (!(status_latch&flags))
+		read_config();
+	return status_latch;
+}	// read_status
+
+uint8_t TMP117::queue_transaction(	transaction_type_et type, uint8_t reg, uint16_t data, 
+									transaction_cb_t callback, void * context, bool keep)
+{	// queue_transaction
+	uint8_t handle=TRANSACTION_INVALID;
+	transaction_st & entry=queue[queue_tail];
+	if (entry.state==ENTRY_FREE)
+	{	// free entry, slots with unfetched results block the queue
+		entry.callback=callback;
+		entry.context=context;
+		entry.data=data;
+		entry.reg=reg;
+		entry.type=type;
+		entry.step=0;
+		entry.keep=keep;
+		entry.ok=true;
+		entry.state=ENTRY_PENDING;
+		handle=queue_tail+1;
+		queue_tail=(queue_tail+1)%TMP117_QUEUE_SIZE;
+	}	// free entry
+	return handle;
+}	// queue_transaction
+
+bool TMP117::process_transaction(transaction_st & entry)	// one step, true if finished
+{	// process_transaction
+	bool finished=false;
+	bus_ok=true;
+	switch (entry.type)
+	{	// switch type
+		case TRANSACTION_READ:
+			if (pointer_reg!=entry.reg)
+				// a blocking call may have moved the pointer in between
+				write_pointer(entry.reg);
+			else
+			{	// pointer set, fetch data
+				read_data(entry.data);
+				finished=true;
+			}	// pointer set, fetch data
+			break;
+		case TRANSACTION_WRITE:
+		case TRANSACTION_EEPROM_LOCK:
+			write_word(entry.reg,entry.data);
+			finished=true;
+			break;
+		case TRANSACTION_EEPROM_WRITE:
+			if (entry.step==0)
+			{	// write and start delay
+				write_word(entry.reg,entry.data);
+				time=millis();
+				entry.step++;
+			}	// write and start delay
+			else if (entry.step==1)
+			{	// delay required time before polling
+				if ((uint16_t)(millis()-time)>EEPROM_WRITE_DELAY)
+					entry.step++;
+			}	// delay required time before polling
+			else if (entry.step==2)
+			{	// poll
+				if (!(read_config()&CONFIG_EEPROM_BUSY))
+					entry.step++;
+			}	// poll
+			else
+			{	// verify, status flags of configuration register latched
+				uint16_t mask=(entry.reg==REG_CONFIGURATION)?(~CONFIG_STATUS_MASK):(0xFFFF);
+				uint16_t val=(entry.reg==REG_CONFIGURATION)?(read_config()):(read_word(entry.reg));
+				if ((val^entry.data)&mask)
+					eeprom_result=EEPROM_RESULT_VERIFY_FAILED;
+				finished=true;
+			}	// verify
+			break;
+		case TRANSACTION_MEASURE:
+			if (!entry.ok)
+				// trigger failed
+				bus_ok=false;
+			else if ((int32_t)(millis()-entry.deadline)>=0)
+			{	// conversion finished, single read
+				entry.data=read_word(REG_TEMPERATURE);
+				finished=true;
+			}	// conversion finished, single read
+			break;
+		case TRANSACTION_EEPROM_WAIT:
+		default:
+			// EEPROM Flag in configuration register will be
+			// high during reset and write operation
+			finished=!(read_config()&CONFIG_EEPROM_BUSY);
+			break;
+	}	// switch type
+	if (!bus_ok)
+	{	// retries exhausted, give up entry
+		// a failed unlock leaves the values in the volatile registers only,
+		// a failed lock leaves the EEPROM unlocked
+		if ((entry.type==TRANSACTION_EEPROM_WRITE) || (entry.type==TRANSACTION_EEPROM_LOCK))
+			eeprom_result=EEPROM_RESULT_BUS_ERROR;
+		entry.ok=false;
+		finished=true;
+	}	// retries exhausted, give up entry
+	return finished;
+}	// process_transaction
+
+uint8_t TMP117::queue_free(void)						// consecutive free entries
+{	// queue_free
+	uint8_t count=0;
+	while ((count<TMP117_QUEUE_SIZE) && 
+			(queue[(queue_tail+count)%TMP117_QUEUE_SIZE].state==ENTRY_FREE))
+		count++;
+	return count;
+}	// queue_free
+
+void TMP117::eeprom_set_done(TMP117 & sensor, uint8_t reg, uint16_t data, void * context)
+{	// eeprom_set_done
+	(void)reg;
+	(void)data;
+	(void)context;
+	if (sensor.eeprom_pending)
+		sensor.eeprom_pending--;
+	if (!sensor.eeprom_pending && (sensor.eeprom_result==EEPROM_RESULT_BUSY))
+		sensor.eeprom_result=EEPROM_RESULT_OK;
+}	// eeprom_set_done
+
+bool TMP117::transfer(bus_op_et op, uint8_t reg, uint16_t & data)	// retries, recovery, health counters
+{	// transfer
+	uint32_t start=micros();
+	uint32_t latency;
+	bool ok=false;
+	for (uint8_t attempt=0; !ok && (attempt<=TMP117_RETRIES); attempt++)
+	{	// attempts
+		uint32_t attempt_start=(attempt)?(micros()):(start);
+		if (attempt)
+			health.retries++;
+		switch (op)
+		{	// switch op
+			case BUS_POINTER:
+				ok=transport.writePointer(i2c_address,reg);
+				break;
+			case BUS_READ_DATA:
+				ok=transport.readData(i2c_address,data);
+				break;
+			case BUS_READ:
+				ok=transport.readRegister(i2c_address,reg,data);
+				break;
+			case BUS_WRITE:
+			default:
+				ok=transport.writeRegister(i2c_address,reg,data);
+				break;
+		}	// switch op
+		if (!ok)
+			health.nacks++;
+		if (trace)
+			// bus_op_et and TMP117Trace::op_et share their order
+			trace->record(attempt_start,i2c_address,reg,(TMP117Trace::op_et)op,ok,data);
+		// a NACK is retried as is, a timeout or SDA held low first needs a released bus
+		if (!ok && transport.isStuck() && transport.recover())
+			health.recoveries++;
+	}	// attempts
+	health.transfers++;
+	if (ok)
+	{	// pointer follows every access with register address
+		if (op!=BUS_READ_DATA)
+			pointer_reg=reg;
+	}	// pointer follows every access with register address
+	else
+	{	// bus or chip stuck
+		health.failures++;
+		pointer_reg=POINTER_UNKNOWN;
+	}	// bus or chip stuck
+	latency=micros()-start;
+	if (latency>health.worstLatency)
+		health.worstLatency=latency;
+	bus_ok=ok;
+	return ok;
+}	// transfer
+
+bool TMP117::write_pointer(uint8_t reg)
+{	// write_pointer
+	uint16_t data=0;
+	return transfer(BUS_POINTER,reg,data);
+}	// write_pointer
+
+bool TMP117::read_data(uint16_t & data)
+{	// read_data
+	return transfer(BUS_READ_DATA,pointer_reg,data);
+}	// read_data
+
+bool TMP117::read_word(uint8_t reg, uint16_t & data)
+{	// read_word(uint8_t reg, uint16_t & data)
+	return transfer(BUS_READ,reg,data);
+}	// read_word(uint8_t reg, uint16_t & data)
+
+uint16_t TMP117::read_word(uint8_t reg)			// 0 on bus error
+{	// read_word(uint8_t reg)
+	uint16_t data;
+	return (read_word(reg,data))?(data):(0);
+}	// read_word(uint8_t reg)
+
+bool TMP117::write_word(uint8_t reg, uint16_t val)
 {	// write_word
-	Wire.beginTransmission(i2c_address);
-	Wire.write(reg);
-	Wire.write((val>>8)&0x00FF);
-	Wire.write(val&0x00FF);
-	Wire.endTransmission();
+	return transfer(BUS_WRITE,reg,val);
 }	// write_word
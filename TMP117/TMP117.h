@@ -3,6 +3,39 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
+#include "TMP117Convert.h"
+
+#ifndef TMP117_ISR_ATTR
+#if defined(ARDUINO_ARCH_ESP32) || defined(ARDUINO_ARCH_ESP8266)
+#define TMP117_ISR_ATTR		IRAM_ATTR	// ISR needs to be placed in RAM
+#else
+#define TMP117_ISR_ATTR
+#endif
+#endif
+
+// transport policy, selected at compile time, no virtual dispatch
+// e.g. -DTMP117_TRANSPORT=TMP117LinuxTransport -DTMP117_TRANSPORT_HEADER=\"TMP117LinuxTransport.h\"
+#ifdef TMP117_TRANSPORT_HEADER
+#include TMP117_TRANSPORT_HEADER
+#else
+#include "TMP117WireTransport.h"
+#endif
+
+#ifndef TMP117_TRANSPORT
+#define TMP117_TRANSPORT	TMP117WireTransport
+#endif
+
+#ifndef TMP117_RETRIES
+#define TMP117_RETRIES		2		// repetitions of a failed transfer
+#endif
+
+#ifndef TMP117_QUEUE_SIZE
+#define TMP117_QUEUE_SIZE	8		// number of entries in the transaction queue
+#endif
+
+class TMP117SampleRing;
+class TMP117Trace;
 
 class TMP117
 {
@@ -51,16 +84,128 @@ class TMP117
 								TEMPERATURE_OFFSET,
 								EEPROM_POS_3 
 								} eeprom_pos_et;
+		
+		typedef enum:uint8_t {	EEPROM_RESULT_IDLE,			// nothing written yet
+								EEPROM_RESULT_BUSY,			// writes pending
+								EEPROM_RESULT_OK,			// all values written and verified
+								EEPROM_RESULT_VERIFY_FAILED,// read back differs
+								EEPROM_RESULT_BUS_ERROR		// write or read back failed
+								} eeprom_result_et;
+	
+		static const uint8_t	REG_TEMPERATURE		=0;
+		static const uint8_t	REG_CONFIGURATION	=1;
+		static const uint8_t	REG_HIGH_TEMP_LIMIT	=2;
+		static const uint8_t	REG_LOW_TEMP_LIMIT	=3;
+		static const uint8_t	REG_EEPROM_UNLOCK	=4;
+		static const uint8_t	REG_EEPROM_1		=5;
+		static const uint8_t	REG_EEPROM_2		=6;
+		static const uint8_t	REG_TEMP_OFFSET		=7;
+		static const uint8_t	REG_EEPROM_3		=8;
+		static const uint8_t	REG_DEVICE_ID		=15;
+		
+		// register encoding, independent of compiler bitfield layout
+		static const uint16_t	CONFIG_SOFT_RESET		=0x0002;	// 1=reset
+		static const uint16_t	CONFIG_ALERT_PIN_SELECT	=0x0004;	// 1=data ready, 0=alert
+		static const uint16_t	CONFIG_ALERT_POLARITY	=0x0008;	// 1=active high, 0=active low
+		static const uint16_t	CONFIG_ALERT_MODE		=0x0010;	// 1=therm, 0=alert
+		static const uint8_t	CONFIG_AVERAGING_SHIFT	=5;			// averaging_mode_et
+		static const uint16_t	CONFIG_AVERAGING_MASK	=0x0060;
+		static const uint8_t	CONFIG_CONVERSION_SHIFT	=7;			// conversion_time_et
+		static const uint16_t	CONFIG_CONVERSION_MASK	=0x0380;
+		static const uint8_t	CONFIG_MODE_SHIFT		=10;		// conversion_mode_et
+		static const uint16_t	CONFIG_MODE_MASK		=0x0C00;
+		static const uint16_t	CONFIG_EEPROM_BUSY		=0x1000;	// 1=write operation in progress
+		static const uint16_t	CONFIG_DATA_READY		=0x2000;	// 1=new temperature value
+		static const uint16_t	CONFIG_LOW_ALERT		=0x4000;	// 1=temperature below low limit
+		static const uint16_t	CONFIG_HIGH_ALERT		=0x8000;	// 1=temperature above high limit
+		
+		static const uint16_t	EEPROM_UNLOCK_BUSY		=0x4000;	// 1=write operation in progress
+		static const uint16_t	EEPROM_UNLOCK_EUN		=0x8000;	// 1=unlocked, write to EEPROM
+																	// 0=locked, write to register
+		static const uint16_t	DEVICE_ID_MASK			=0x0FFF;	// device ID (0x117)
+		static const uint16_t	DEVICE_ID				=0x0117;
+		static const uint8_t	DEVICE_REV_SHIFT		=12;		// device revision (currently 0)
+		
+		static const uint32_t	CURRENT_ACTIVE_NA	=135000;	// supply current during conversion (typ.)
+		static const uint32_t	CURRENT_STANDBY_NA	=1250;		// standby current between conversions (typ.)
+		static const uint32_t	CURRENT_SHUTDOWN_NA	=150;		// supply current in shutdown (typ.)
+		
+		static const uint8_t	TEMP_READ_BITS		=49;		// bus clocks to read temperature: pointer + data
+		static const uint8_t	STATUS_READ_BITS	=49;		// bus clocks to poll data ready: pointer + configuration
+		
+		static const uint8_t	CHANGED_CONFIG		=0x01;	// warm start: registers written
+		static const uint8_t	CHANGED_HIGH_LIMIT	=0x02;
+		static const uint8_t	CHANGED_LOW_LIMIT	=0x04;
+		static const uint8_t	CHANGED_OFFSET		=0x08;
+		static const uint8_t	CHANGED_EEPROM		=0x10;	// power up defaults queued for programming
+		
+		static const uint8_t	TRANSACTION_INVALID	=0;		// handle returned if queue is full
+		
+		typedef struct sample_s {	uint32_t	timestamp;		// ms
+									int16_t		temp;			// IQ9.7
+								}	sample_st;
+		
+		typedef struct status_s {	bool		dataReady;
+									bool		highAlert;
+									bool		lowAlert;
+									bool		eepromBusy;
+									bool		busOk;			// false: bus error, flags are the latched ones
+									bool		tempValid;		// temp has been read
+									int16_t		temp;			// IQ9.7
+								}	status_st;
+		
+		typedef struct profile_s {	uint16_t	config;			// configuration register
+									int16_t		highLimit;		// IQ9.7
+									int16_t		lowLimit;		// IQ9.7
+									int16_t		offset;			// IQ9.7, temperature offset (warm start only)
+									bool		writeOffset;	// false: offset of the chip (calibration) is kept
+								}	profile_st;
+		
+		typedef struct health_s {	uint32_t	transfers;		// bus operations
+									uint32_t	nacks;			// failed attempts (NACK, timeout)
+									uint32_t	retries;
+									uint32_t	recoveries;		// successful bus recoveries
+									uint32_t	failures;		// operations failed after all retries
+									uint32_t	worstLatency;	// µs, longest operation incl. retries
+								}	health_st;
+		
+		typedef TMP117_TRANSPORT transport_t;
 	
+		typedef void (*transaction_cb_t)(TMP117 & sensor, uint8_t reg, uint16_t data, void * context);
 	
 		TMP117(uint8_t addr, uint8_t alert_pin=-1);		// Constructor with i2c address and int pin
+		TMP117(transport_t & transport, uint8_t addr, uint8_t alert_pin=-1);	// as above on given transport
 		
-		bool init(void);
+		bool init(void);				// test if chip exists, set int pin and load register shadow
+		bool init(const profile_st & profile);	// as above, write profile instead of loading shadow
+		bool init(const profile_st & profile, uint8_t & changes, bool persist=false);	// warm start, read chip
+																			// state, write differences only
 			
 		bool process_idle(void);	// non blocking processing, returns true if idle
 		
+		uint8_t queueRead(uint8_t reg, transaction_cb_t callback=NULL, void * context=NULL);				// queue register read, returns handle
+		uint8_t queueWrite(uint8_t reg, uint16_t val, transaction_cb_t callback=NULL, void * context=NULL);	// queue register write, returns handle
+		bool isTransactionDone(uint8_t handle);							// test if queued transaction has finished
+		uint8_t requestMeasurement(transaction_cb_t callback=NULL, void * context=NULL);	// start one-shot, temperature 
+																							// read once after deadline
+		uint32_t getMeasurementDeadline(void);							// millis() when last requested result is read
+		bool getTransactionResult(uint8_t handle, uint16_t & data);		// get data and release handle, 
+																		// false if not done or failed
+		
 		bool isAlert(void);				// test Alert Pin
 		
+		bool enableDataReadyCapture(TMP117SampleRing & ring);	// capture samples on data ready interrupt
+																// false if pin has no interrupt
+		void disableDataReadyCapture(void);
+		uint16_t getCaptureOverruns(void);						// samples lost since enable
+		uint16_t getCaptureFailures(void);						// failed reads since enable, retried
+		
+		bool isBusOk(void);						// last bus operation succeeded
+		const health_st & getHealth(void);		// bus error counters
+		void resetHealth(void);
+		
+		void setTrace(TMP117Trace * trace);		// record bus operations, NULL stops recording
+		
 		int16_t getTemp(uint8_t decimals);	// gets temperature in decimal fixed point notation
 		int16_t getTemp(void);				// gets temperature in binary s8.7 fixed point notiation
 		
@@ -74,6 +219,22 @@ class TMP117
 		int16_t getLowTemperaturLimit(uint8_t decimals);	// get value in decimal fixed point notation
 		int16_t getLowTemperaturLimit(void);                // get value in binary s8.7 fixed point notation
 		
+		// 32 bit, unit and scale (e.g. 1000: milli degrees) selected at compile time, see TMP117Convert
+		template<TMP117Convert::unit_et UNIT=TMP117Convert::UNIT_CELSIUS, int32_t SCALE=1000> 
+		int32_t getTempScaled(void);							// INT32_MIN on bus error
+		template<TMP117Convert::unit_et UNIT=TMP117Convert::UNIT_CELSIUS, int32_t SCALE=1000> 
+		void setHighTemperaturLimitScaled(int32_t temp);
+		template<TMP117Convert::unit_et UNIT=TMP117Convert::UNIT_CELSIUS, int32_t SCALE=1000> 
+		void setLowTemperaturLimitScaled(int32_t temp);
+		template<TMP117Convert::unit_et UNIT=TMP117Convert::UNIT_CELSIUS, int32_t SCALE=1000> 
+		void setTemperaturLimitsScaled(int32_t high, int32_t low);	// both limits in one batch
+		template<TMP117Convert::unit_et UNIT=TMP117Convert::UNIT_CELSIUS, int32_t SCALE=1000> 
+		int32_t getHighTemperaturLimitScaled(void);
+		template<TMP117Convert::unit_et UNIT=TMP117Convert::UNIT_CELSIUS, int32_t SCALE=1000> 
+		int32_t getLowTemperaturLimitScaled(void);
+		template<TMP117Convert::unit_et UNIT=TMP117Convert::UNIT_CELSIUS, int32_t SCALE=1000> 
+		static void convertSamples(const sample_st * samples, int32_t * temp, size_t count);	// bulk
+		
 		uint16_t getDeviceID(void);
 		uint8_t getDeviceRevision(void);
 		
@@ -86,14 +247,37 @@ class TMP117
 		void setConversionTime(conversion_time_et time);
 		void setConversionMode(conversion_mode_et mode);
 		
+		void beginConfig(void);			// collect following configuration changes in the shadow registers
+		void commitConfig(void);		// write each changed register once
 		
-		alert_mode_select_et 	getAlertPinSource(void);
+		alert_pin_select_et 	getAlertPinSource(void);
 		alert_pin_polarity_et 	getAlertPinPolarity(void);
 		alert_mode_select_et 	getAlertMode(void);
 		averaging_mode_et		getAveragingMode(void);
 		conversion_time_et		getConversionTime(void);
 		conversion_mode_et		getConversionMode(void);
+		
+		static constexpr uint16_t encodeConfig(	conversion_mode_et mode, averaging_mode_et averaging,
+												conversion_time_et time, alert_mode_select_et alertMode,
+												alert_pin_polarity_et polarity, alert_pin_select_et source)
+		{	// encodeConfig, configuration register word
+			return	(uint16_t)(	((uint16_t)mode<<CONFIG_MODE_SHIFT) |
+								((uint16_t)time<<CONFIG_CONVERSION_SHIFT) |
+								((uint16_t)averaging<<CONFIG_AVERAGING_SHIFT) |
+								((alertMode==ALERT_MODE_THERMISTOR)?(CONFIG_ALERT_MODE):(0)) |
+								((polarity==ALERT_PIN_ACTIVE_HIGH)?(CONFIG_ALERT_POLARITY):(0)) |
+								((source==ALERT_PIN_DATA_READY)?(CONFIG_ALERT_PIN_SELECT):(0)));
+		}	// encodeConfig
+		
+		static uint16_t getConversionDuration(averaging_mode_et mode);	// active conversion time in ms
+		static uint16_t getMeasurementTime(averaging_mode_et mode);		// one-shot conversion incl. tolerance in ms
+		static uint16_t getConversionCycleTime(conversion_time_et time, averaging_mode_et mode);
+		uint16_t getConversionCycleTime(void);							// time between results in continuous mode in ms
+		static uint32_t getSupplyCurrent(conversion_time_et time, averaging_mode_et mode);	// average in continuous mode in nA
 
+		status_st readStatus(bool readTemp=false);	// read flags once, temperature only if data ready
+		void clearStatus(void);						// clear latched status flags
+		
 		bool isDataReady(void);
 		bool testHighTemperatureAlert(void);
 		bool testLowTemperatureAlert(void);
@@ -101,88 +285,108 @@ class TMP117
 		bool testEepromLocked(void);
 	
 		void setEepromLockState(eeprom_lock_mode_et lock);
-		void writeEeprom(eeprom_pos_et Register, uint16_t val);
-		void writeTemperatureOffset(int16_t val);
+		bool writeEeprom(eeprom_pos_et Register, uint16_t val);	// queues write, false if queue is full
+		bool writeTemperatureOffset(int16_t val);
+		bool writeEepromSet(const uint16_t val[4], uint8_t mask=0x0F);	// unlock, write, verify and lock
+																		// val and mask bits indexed by eeprom_pos_et
+		eeprom_result_et getEepromResult(void);
 		
 		uint16_t readEeprom(eeprom_pos_et Register);
 		int16_t readTemperatureOffset(void);
 		
+		// offset is a difference, converted without the zero point of the unit
+		template<TMP117Convert::unit_et UNIT=TMP117Convert::UNIT_CELSIUS, int32_t SCALE=1000> 
+		bool writeTemperatureOffsetScaled(int32_t offset);
+		template<TMP117Convert::unit_et UNIT=TMP117Convert::UNIT_CELSIUS, int32_t SCALE=1000> 
+		int32_t readTemperatureOffsetScaled(void);
+		
 		
 	private:
 
-		static const uint8_t	REG_TEMPERATURE		=0;
-		static const uint8_t	REG_CONFIGURATION	=1;
-		static const uint8_t	REG_HIGH_TEMP_LIMIT	=2;
-		static const uint8_t	REG_LOW_TEMP_LIMIT	=3;
-		static const uint8_t	REG_EEPROM_UNLOCK	=4;
-		static const uint8_t	REG_EEPROM_1		=5;
-		static const uint8_t	REG_EEPROM_2		=6;
-		static const uint8_t	REG_TEMP_OFFSET		=7;
-		static const uint8_t	REG_EEPROM_3		=8;
-		static const uint8_t	REG_DEVICE_ID		=15;
-		
 		static const uint8_t	EEPROM_WRITE_DELAY	=7;
+		static const uint8_t	POINTER_UNKNOWN		=0xFF;
+		
+		static const uint8_t	SHADOW_CONFIGURATION=0x01;	// shadow register flags for 
+		static const uint8_t	SHADOW_HIGH_LIMIT	=0x02;	// pending changes in batch mode
+		static const uint8_t	SHADOW_LOW_LIMIT	=0x04;
+		static const uint16_t	SHADOW_CONFIG_RESET	=0x0220;	// factory defaults until the shadow is loaded:
+		static const int16_t	SHADOW_HIGH_RESET	=0x6000;	// continuous, 1s, 8x, 192°C, -256°C
+		static const int16_t	SHADOW_LOW_RESET	=INT16_MIN;
+		
+		static const uint8_t	ISR_INSTANCES		=4;		// sensors capturing at the same time
+		
+		static const uint16_t	STATUS_HIGH_ALERT	=CONFIG_HIGH_ALERT;	// latched status flags
+		static const uint16_t	STATUS_LOW_ALERT	=CONFIG_LOW_ALERT;
+		static const uint16_t	STATUS_DATA_READY	=CONFIG_DATA_READY;
+		static const uint16_t	STATUS_LATCH_MASK	=STATUS_HIGH_ALERT|STATUS_LOW_ALERT|STATUS_DATA_READY;
+		
+		// read only flags and reset bit, never written back from shadow
+		static const uint16_t	CONFIG_STATUS_MASK	=STATUS_LATCH_MASK|CONFIG_EEPROM_BUSY|CONFIG_SOFT_RESET;
+
+		typedef enum:uint8_t {	TRANSACTION_READ,			// set pointer, read data
+								TRANSACTION_WRITE,			// write data
+								TRANSACTION_EEPROM_WRITE,	// write data, wait, poll EEPROM busy flag, verify
+								TRANSACTION_EEPROM_LOCK,	// write unlock register, part of an EEPROM set
+								TRANSACTION_EEPROM_WAIT,	// poll EEPROM busy flag (reset, power up)
+								TRANSACTION_MEASURE			// wait for deadline, read temperature
+							}	transaction_type_et;
+		
+		typedef enum:uint8_t {	ENTRY_FREE,
+								ENTRY_PENDING,
+								ENTRY_DONE					// result waiting to be fetched
+							}	entry_state_et;
+		
+		typedef struct transaction_s {	transaction_cb_t	callback;
+										void *				context;
+										uint32_t			deadline;	// TRANSACTION_MEASURE: millis() of result
+										uint16_t			data;
+										uint8_t				reg;
+										transaction_type_et	type;
+										entry_state_et		state;
+										uint8_t				step;
+										bool				keep;		// keep result for polling
+										bool				ok;			// no bus error
+									}	transaction_st;
 
-		typedef enum:uint8_t {	EEPROM_IDLE,
-								EEPROM_WRITE_WRITE,
-								EEPROM_WRITE_WAIT,
-								EEPROM_WRITE_BUSY,
-								EEPROM_START
-							}	eeprom_process_et;
-
-		typedef struct configReg_s { 	uint16_t reserved:1;
-										uint16_t SoftReset:1;			// 1=Reset
-										uint16_t AlertPinSelect:1;		// 0=Alert, 1=Date Ready
-										uint16_t AlertPinPolarity:1;	// 1=active high, 0=active low
-										uint16_t AlertMode:1;			// 1=Thermistor, 0=Alert
-										uint16_t AveragingMode:2;		// 00=off, 01=8, 10=32, 11=64
-										uint16_t ConversionCycleTime:3;	// 000: off no delay, 64/s
-																		// 001:  125ms,	8/s
-																		// 010:  500ms,	2/s
-																		// 011: 1000ms,	1/s
-																		// 100:	2000ms,	1/2s
-																		// 101: 4000ms,	1/4s
-																		// 110: 8000ms,	1/8s
-																		// 111:16000ms,	1/16s
-										uint16_t ConversionMode:2;		// 00: Continuous conversion (CC)
-																		// 01: Shutdown (SD)
-																		// 10: Continuous conversion (CC), Same as 00 (reads back = 00)
-																		// 11: One-shot conversion (OS)
-										uint16_t EEPROM_Busy:1;			// 1= write operation in progress
-										uint16_t DataReady:1;			// 1= new temperature value in temperature register
-										uint16_t lowTempAlert:1;		// 1= new temperature is below low limit
-										uint16_t highTempAlert:1;		// 1= new temperature is above high limit
-									}	configReg_st;
-									
-		typedef union configReg_u	{	uint16_t 		RegisterData;
-										configReg_st 	Flags;
-									}	configReg_ut;
-									
-		typedef struct EEPROM_UnlockReg_s {	uint16_t reserved:14;		// reserved
-											uint16_t EUN:1;				// 1=unlocked, write to EEPROM, 
-																		// 0=locked, write to temp. register
-											uint16_t EEPROM_Busy:1;		// 1= write operation in progress
-										}	EEPROM_UnlockReg_st;
-										
-		typedef union EEPROM_UnlockReg_u {	uint16_t RegisterData;
-											EEPROM_UnlockReg_st Flags;
-										 }	EEPROM_UnlockReg_ut;
-										 
-		typedef struct deviceID_s 	{	uint16_t ID:12;					// Device ID (0x117)
-										uint16_t Rev:4;					// Device Revision (currently 0) 
-									}	deviceID_st;
-		
-		typedef union deviceID_u	{	uint16_t RegisterData;
-										deviceID_st Flags;
-									}	deviceID_ut;
-
-		eeprom_process_et	eeprom_state;
-		configReg_ut		configReg;
+		transaction_st		queue[TMP117_QUEUE_SIZE];
+		uint8_t				queue_head;			// oldest pending transaction
+		uint8_t				queue_tail;			// next entry to be filled
+		uint8_t				pointer_reg;		// content of chip pointer register
+		eeprom_result_et	eeprom_result;
+		uint8_t				eeprom_pending;		// queued EEPROM operations
+		uint32_t			measure_deadline;	// last requested one-shot result
+		uint16_t			configReg;			// shadow of configuration register
+		int16_t				highLimit;			// shadow of high limit register
+		int16_t				lowLimit;			// shadow of low limit register
+		bool				shadow_valid;		// shadow registers hold chip content
+		bool				config_batch;		// true between beginConfig and commitConfig
+		uint8_t				shadow_dirty;		// registers changed during batch
+		uint16_t			status_latch;		// status flags read from chip, not yet cleared
 
+		transport_t &		transport;
+		bool				bus_ok;				// result of last bus operation
+		health_st			health;
+		TMP117Trace *		trace;				// NULL if not recording
 		uint8_t 			i2c_address;
 		uint16_t			time;
 		uint8_t				int_pin;
 		bool				int_pin_active_high;
+		
+		TMP117SampleRing *	capture_ring;		// NULL if capture is disabled
+		uint8_t				capture_slot;		// index in isr_instance
+		volatile bool		capture_pending;	// set by ISR
+		volatile uint32_t	capture_time;		// set by ISR
+		volatile uint16_t	capture_overruns;
+		uint16_t			capture_failures;	// task function only
+		
+		static TMP117 *		isr_instance[ISR_INSTANCES];
+		
+		static void isr_0(void);
+		static void isr_1(void);
+		static void isr_2(void);
+		static void isr_3(void);
+		void data_ready_isr(void);
+		void capture_sample(void);
 
 
 		int16_t convertToIQ(int16_t valDec, uint8_t decimals);	// converts a value given as
@@ -194,8 +398,89 @@ class TMP117
 																// 9,5°C given as IQ 9.7 equals 0x04C0 
 																// (0x04C0,1) yields in 95	 
 		
-		uint16_t read_word(uint8_t reg);
-		void write_word(uint8_t reg, uint16_t val);
+		bool probe(void);						// test if chip exists, set int pin
+		void drop_startup_wait(void);			// EEPROM loaded, remove wait queued by constructor
+		bool persist_profile(const profile_st & profile, uint16_t signature);	// queue EEPROM programming
+		static uint16_t profile_signature(const profile_st & profile);	// stored in EEPROM_POS_3
+		bool load_shadow(void);					// read configuration and limits into shadow, false on bus error
+		uint16_t get_config(uint16_t mask);					// masked bits of configuration shadow
+		void set_config(uint16_t mask, uint16_t value);		// replace masked bits of configuration shadow
+		void update_register(uint8_t shadow);	// write shadow register or mark as dirty in batch mode
+		void write_config(void);				// write configuration shadow to chip
+		uint16_t read_config(void);				// read configuration register, latch status flags
+		uint16_t read_status(uint16_t flags);	// latched flags, read chip if none of flags is latched
+
+		uint8_t queue_transaction(transaction_type_et type, uint8_t reg, uint16_t data, transaction_cb_t callback, void * context, bool keep=false);
+		bool process_transaction(transaction_st & entry);	// one step, true if finished
+		uint8_t queue_free(void);							// consecutive free entries
+		static void eeprom_set_done(TMP117 & sensor, uint8_t reg, uint16_t data, void * context);
+		
+		typedef enum:uint8_t {	BUS_POINTER,
+								BUS_READ_DATA,
+								BUS_READ,
+								BUS_WRITE
+								} bus_op_et;
+		
+		bool transfer(bus_op_et op, uint8_t reg, uint16_t & data);	// retries, recovery, health counters
+		bool write_pointer(uint8_t reg);
+		bool read_data(uint16_t & data);
+		bool read_word(uint8_t reg, uint16_t & data);
+		uint16_t read_word(uint8_t reg);			// 0 on bus error
+		bool write_word(uint8_t reg, uint16_t val);
 };
 
+/* *********************************************************************
+ * 32 bit temperature interface
+ * ********************************************************************* */
+
+template<TMP117Convert::unit_et UNIT, int32_t SCALE> int32_t TMP117::getTempScaled(void)
+{	// getTempScaled
+	return TMP117Convert::toWide<UNIT,SCALE>(getTemp());
+}	// getTempScaled
+
+template<TMP117Convert::unit_et UNIT, int32_t SCALE> void TMP117::setHighTemperaturLimitScaled(int32_t temp)
+{	// setHighTemperaturLimitScaled
+	setHighTemperaturLimit(TMP117Convert::fromWide<UNIT,SCALE>(temp));
+}	// setHighTemperaturLimitScaled
+
+template<TMP117Convert::unit_et UNIT, int32_t SCALE> void TMP117::setLowTemperaturLimitScaled(int32_t temp)
+{	// setLowTemperaturLimitScaled
+	setLowTemperaturLimit(TMP117Convert::fromWide<UNIT,SCALE>(temp));
+}	// setLowTemperaturLimitScaled
+
+template<TMP117Convert::unit_et UNIT, int32_t SCALE> void TMP117::setTemperaturLimitsScaled(int32_t high, int32_t low)
+{	// setTemperaturLimitsScaled
+	bool batch=config_batch;
+	if (!batch) beginConfig();
+	setHighTemperaturLimit(TMP117Convert::fromWide<UNIT,SCALE>(high));
+	setLowTemperaturLimit(TMP117Convert::fromWide<UNIT,SCALE>(low));
+	if (!batch) commitConfig();
+}	// setTemperaturLimitsScaled
+
+template<TMP117Convert::unit_et UNIT, int32_t SCALE> int32_t TMP117::getHighTemperaturLimitScaled(void)
+{	// getHighTemperaturLimitScaled
+	return TMP117Convert::toWide<UNIT,SCALE>(getHighTemperaturLimit());
+}	// getHighTemperaturLimitScaled
+
+template<TMP117Convert::unit_et UNIT, int32_t SCALE> int32_t TMP117::getLowTemperaturLimitScaled(void)
+{	// getLowTemperaturLimitScaled
+	return TMP117Convert::toWide<UNIT,SCALE>(getLowTemperaturLimit());
+}	// getLowTemperaturLimitScaled
+
+template<TMP117Convert::unit_et UNIT, int32_t SCALE> void TMP117::convertSamples(const sample_st * samples, int32_t * temp, size_t count)
+{	// convertSamples
+	for (size_t n=0; n<count; n++)
+		temp[n]=TMP117Convert::toWide<UNIT,SCALE>(samples[n].temp);
+}	// convertSamples
+
+template<TMP117Convert::unit_et UNIT, int32_t SCALE> bool TMP117::writeTemperatureOffsetScaled(int32_t offset)
+{	// writeTemperatureOffsetScaled
+	return writeTemperatureOffset(TMP117Convert::fromWideDelta<UNIT,SCALE>(offset));
+}	// writeTemperatureOffsetScaled
+
+template<TMP117Convert::unit_et UNIT, int32_t SCALE> int32_t TMP117::readTemperatureOffsetScaled(void)
+{	// readTemperatureOffsetScaled
+	return TMP117Convert::toWideDelta<UNIT,SCALE>(readTemperatureOffset());
+}	// readTemperatureOffsetScaled
+
 #endif // _TMP117_
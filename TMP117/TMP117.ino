@@ -1,15 +1,59 @@
 #include "Wire.h"
 #include "TMP117.h"
+#include "TMP117SampleRing.h"
+#include "TMP117Telemetry.h"
 
-TMP117 sensor(0x4F);
+// two sensors at 64 conversions per second, ALERT pins as data ready
+// interrupt, streamed as binary frames (host/telemetry decodes them)
+
+#define SENSORS		2
+#define RING_SIZE	16
+
+TMP117 sensor0(0x48,2);
+TMP117 sensor1(0x49,3);
+TMP117 * sensor[SENSORS]={&sensor0,&sensor1};
+
+TMP117::sample_st ring_storage[SENSORS][RING_SIZE];
+TMP117SampleRing ring[SENSORS];
+
+TMP117Telemetry::channel_st channel[SENSORS];
+TMP117Telemetry telemetry;
 
 void setup(void)
 {
+	Serial.begin(115200);
 	Wire.begin();
-	Wire.setClock(100000);
+	// restored after a bus recovery
+	TMP117WireTransport::getDefault().setClock(400000);
+	
+	for (uint8_t n=0; n<SENSORS; n++)
+	{	// configure sensors
+		while (!sensor[n]->process_idle());		// EEPROM load after power up
+		if (!sensor[n]->init())
+			continue;
+		sensor[n]->beginConfig();
+		sensor[n]->setConversionTime(TMP117::CONVERSION_TIME_1_64s);
+		sensor[n]->setAveragingMode(TMP117::AVERAGING_OFF);
+		sensor[n]->setConversionMode(TMP117::MODE_CONTINUOUS);
+		sensor[n]->commitConfig();
+		ring[n].begin(ring_storage[n],RING_SIZE);
+		sensor[n]->enableDataReadyCapture(ring[n]);
+	}	// configure sensors
+	
+	// partial frames are sent after 500ms
+	telemetry.begin(Serial,channel,SENSORS,500);
 }
 
 
 void loop(void)
 {
+	TMP117::sample_st sample;
+	for (uint8_t n=0; n<SENSORS; n++)
+	{	// collect samples
+		sensor[n]->process_idle();
+		while (ring[n].pop(sample))
+			telemetry.add(n,sample);
+	}	// collect samples
+	// writes only as much as the serial buffer takes
+	telemetry.process_idle();
 }
@@ -0,0 +1,142 @@
+#include <Arduino.h>
+#include "TMP117Bus.h"
+
+TMP117Bus::TMP117Bus(void)
+{	// constructor
+	count=0;
+	next=0;
+	updated=0;
+	resync_due=0;
+	resync=RESYNC_CYCLES;
+	state=BUS_IDLE;
+	period=0;
+	margin=0;
+}	// constructor
+
+bool TMP117Bus::addSensor(TMP117 & sensor)		// adds an initialized sensor, false if bus is full
+{	// addSensor
+	bool added=(count<MAX_SENSORS) && (state==BUS_IDLE);
+	if (added)
+	{	// add
+		this->sensor[count]=&sensor;
+		samples[count].timestamp=0;
+		samples[count].temp=0;
+		count++;
+	}	// add
+	return added;
+}	// addSensor
+
+void TMP117Bus::start(void)						// start staggered continuous conversion
+{	// start
+	period=0;
+	for (uint8_t n=0; n<count; n++)
+	{	// common period is the slowest sensor
+		uint16_t cycle=sensor[n]->getConversionCycleTime();
+		if (cycle>period)
+			period=cycle;
+	}	// common period is the slowest sensor
+	margin=(period>>4)+1;
+	next=0;
+	updated=0;
+	resync_due=0;
+	start_time=millis();
+	state=(count)?(BUS_STARTING):(BUS_IDLE);
+}	// start
+
+void TMP117Bus::stop(void)						// shut down all sensors
+{	// stop
+	for (uint8_t n=0; n<count; n++)
+		sensor[n]->setConversionMode(TMP117::MODE_SHUTDOWN);
+	state=BUS_IDLE;
+}	// stop
+
+bool TMP117Bus::process_idle(void)
+{	// process_idle
+	bool idle=true;
+	uint32_t now=millis();
+	switch (state)
+	{	// switch state
+		case BUS_STARTING:
+			// spread start of conversion cycles evenly over one period
+			if ((now-start_time)>=(uint32_t)next*period/count)
+			{	// start next sensor
+				restart(next);
+				next++;
+				if (next>=count)
+				{	// all started
+					next=0;
+					state=BUS_RUNNING;
+				}	// all started
+				idle=false;
+			}	// start next sensor
+			break;
+		case BUS_RUNNING:
+			for (uint8_t i=0; (i<count) && idle; i++)
+			{	// round robin, first sensor due is read
+				uint8_t n=(next+i)%count;
+				if (	(resync_due&(1<<n)) &&
+						((int32_t)(now-due[n]+TMP117::getConversionDuration(sensor[n]->getAveragingMode()))>=0))
+				{	// restart, new conversion ends on the regular due time
+					resync_due&=~(1<<n);
+					restart(n);
+					idle=false;
+				}	// restart
+				else if ((int32_t)(now-due[n])>=(int32_t)margin)
+				{	// read
+					int16_t temp=sensor[n]->getTemp();
+					if (sensor[n]->isBusOk())
+					{	// keep last valid sample on bus error
+						samples[n].temp=temp;
+						samples[n].timestamp=due[n];
+						updated|=1<<n;
+					}	// keep last valid sample on bus error
+					next=(n+1)%count;
+					due[n]+=period;
+					if (++cycles[n]>=resync)
+						// keep in phase with the sensors oscillator 
+						resync_due|=1<<n;
+					idle=false;
+				}	// read
+			}	// round robin
+			break;
+		case BUS_IDLE:
+		default:
+			break;
+	}	// switch state
+	return idle;
+}	// process_idle
+
+void TMP117Bus::setResyncCycles(uint8_t cycles)	// samples between conversion cycle restarts
+{	// setResyncCycles
+	resync=(cycles)?(cycles):(1);
+}	// setResyncCycles
+
+uint8_t TMP117Bus::getSensorCount(void)
+{	// getSensorCount
+	return count;
+}	// getSensorCount
+
+const TMP117::sample_st * TMP117Bus::getSamples(void)
+{	// getSamples
+	return samples;
+}	// getSamples
+
+uint8_t TMP117Bus::getUpdated(void)
+{	// getUpdated
+	uint8_t temp=updated;
+	updated=0;
+	return temp;
+}	// getUpdated
+
+/* *********************************************************************
+ * private functions
+ * ********************************************************************* */
+
+void TMP117Bus::restart(uint8_t n)				// restart conversion cycle of sensor n
+{	// restart
+	// writing the configuration register starts a new conversion cycle
+	sensor[n]->setConversionMode(TMP117::MODE_CONTINUOUS);
+	due[n]=millis()+
+		TMP117::getConversionDuration(sensor[n]->getAveragingMode());
+	cycles[n]=0;
+}	// restart
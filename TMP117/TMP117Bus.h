@@ -0,0 +1,57 @@
+#ifndef _TMP117_BUS_
+#define _TMP117_BUS_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "TMP117.h"
+
+class TMP117Bus
+{
+	public:
+	
+		static const uint8_t	MAX_SENSORS	=4;		// 4 selectable I2C addresses per bus
+		static const uint8_t	RESYNC_CYCLES=16;	// default number of samples between restarts
+
+		TMP117Bus(void);
+		
+		bool addSensor(TMP117 & sensor);			// adds an initialized sensor, false if bus is full
+		
+		void start(void);							// start staggered continuous conversion
+		void stop(void);							// shut down all sensors
+		
+		bool process_idle(void);					// non blocking processing, at most one read per call
+													// returns true if no read is due
+		
+		void setResyncCycles(uint8_t cycles);		// samples between conversion cycle restarts
+		
+		uint8_t getSensorCount(void);
+		const TMP117::sample_st * getSamples(void);	// latest sample of each sensor in order of addSensor
+		uint8_t getUpdated(void);					// bit n set if sensor n has a new sample,
+													// cleared by the call
+		
+	private:
+	
+		typedef enum:uint8_t {	BUS_IDLE,
+								BUS_STARTING,
+								BUS_RUNNING
+							}	bus_state_et;
+		
+		TMP117 *			sensor[MAX_SENSORS];
+		TMP117::sample_st	samples[MAX_SENSORS];
+		uint32_t			due[MAX_SENSORS];		// expected end of conversion
+		uint8_t				cycles[MAX_SENSORS];	// samples since last restart
+		
+		bus_state_et		state;
+		uint8_t				count;
+		uint8_t				next;					// next sensor for round robin / start
+		uint8_t				updated;
+		uint8_t				resync_due;				// bit n set: restart sensor n before its next conversion
+		uint8_t				resync;
+		uint32_t			start_time;
+		uint16_t			period;					// common conversion cycle time
+		uint16_t			margin;					// read delay after expected end of conversion
+		
+		void restart(uint8_t n);					// restart conversion cycle of sensor n
+};
+
+#endif // _TMP117_BUS_
@@ -0,0 +1,135 @@
+#include "TMP117Calibration.h"
+#include "TMP117Convert.h"
+
+TMP117Calibration::TMP117Calibration(TMP117 & sensor) : sensor(sensor)
+{	// constructor
+	offset=0;
+	gain=GAIN_ONE;
+	date_code=0;
+	reset();
+}	// constructor
+
+void TMP117Calibration::reset(void)					// discard collected points
+{	// reset
+	n=0;
+	sum_x=0;
+	sum_y=0;
+	sum_xx=0;
+	sum_xy=0;
+}	// reset
+
+void TMP117Calibration::addPoint(int16_t reference, int16_t measured)	// IQ9.7
+{	// addPoint(int16_t reference, int16_t measured)
+	if (n==UINT8_MAX)
+		return;
+	n++;
+	sum_x+=measured;
+	sum_y+=reference;
+	sum_xx+=(int32_t)measured*measured;
+	sum_xy+=(int32_t)measured*reference;
+}	// addPoint(int16_t reference, int16_t measured)
+
+bool TMP117Calibration::addPoint(int16_t reference)	// measured value is read from sensor
+{	// addPoint(int16_t reference)
+	int16_t measured=sensor.getTemp();
+	if (sensor.isBusOk())
+		addPoint(reference,measured);
+	return sensor.isBusOk();
+}	// addPoint(int16_t reference)
+
+uint8_t TMP117Calibration::getPoints(void)
+{	// getPoints
+	return n;
+}	// getPoints
+
+bool TMP117Calibration::compute(bool slope)			// offset only or offset and gain
+{	// compute
+	int64_t num;
+	int64_t den;
+	if (!n || (slope && (n<2)))
+		return false;
+	if (slope)
+	{	// least squares
+		den=(int64_t)n*sum_xx-(int64_t)sum_x*sum_x;
+		if (den<=0)
+			return false;				// all points at the same temperature
+		num=((int64_t)n*sum_xy-(int64_t)sum_x*sum_y)<<14;
+		num=(num+den/2)/den;
+		if ((num<=0) || (num>INT16_MAX))
+			return false;				// gain outside 0..2
+		gain=num;
+	}	// least squares
+	else
+		gain=GAIN_ONE;
+	// offset=(sum_y-gain*sum_x)/n
+	num=((int64_t)sum_y<<14)-(int64_t)gain*sum_x;
+	den=(int64_t)n<<14;
+	num+=(num<0)?(-den/2):(den/2);
+	offset=TMP117Convert::saturate(num/den);
+	return true;
+}	// compute
+
+int16_t TMP117Calibration::getOffset(void)			// IQ9.7
+{	// getOffset
+	return offset;
+}	// getOffset
+
+int16_t TMP117Calibration::getGain(void)				// Q2.14
+{	// getGain
+	return gain;
+}	// getGain
+
+bool TMP117Calibration::commit(uint16_t dateCode)	// queue offset register and metadata to EEPROM
+{	// commit
+	uint16_t val[4];
+	// the points were measured with the current offset, the chip adds 
+	// the new offset before the software gain: gain*(m+offset/gain)
+	int32_t num=(int32_t)offset<<14;
+	int32_t chip=sensor.readTemperatureOffset();
+	if (!sensor.isBusOk())
+		// 0 is not the current offset, nothing is queued
+		return false;
+	// round half away from zero, division truncates toward zero
+	num+=(num<0)?(-gain/2):(gain/2);
+	chip+=num/gain;
+	date_code=dateCode;
+	val[EEPROM_GAIN]=(uint16_t)gain;
+	val[EEPROM_DATE]=dateCode;
+	val[TMP117::TEMPERATURE_OFFSET]=(uint16_t)TMP117Convert::saturate(chip);
+	val[TMP117::EEPROM_POS_3]=0;
+	return sensor.writeEepromSet(val,(1<<EEPROM_GAIN)|(1<<EEPROM_DATE)|(1<<TMP117::TEMPERATURE_OFFSET));
+}	// commit
+
+bool TMP117Calibration::load(void)					// read gain and date code from EEPROM
+{	// load
+	uint16_t val=sensor.readEeprom(EEPROM_GAIN);
+	uint16_t date=0;
+	bool valid=(val>0) && (val<=INT16_MAX);
+	if (!sensor.isBusOk())
+		// keep gain and date code, 0 is not an empty EEPROM
+		return false;
+	if (valid)
+	{	// date code of the gain
+		date=sensor.readEeprom(EEPROM_DATE);
+		if (!sensor.isBusOk())
+			return false;
+	}	// date code of the gain
+	gain=(valid)?((int16_t)val):(GAIN_ONE);
+	date_code=date;
+	offset=0;						// part of the chip offset
+	return valid;
+}	// load
+
+uint16_t TMP117Calibration::getDateCode(void)
+{	// getDateCode
+	return date_code;
+}	// getDateCode
+
+int16_t TMP117Calibration::apply(int16_t temp)		// software gain correction of IQ9.7 sample
+{	// apply
+	int32_t val;
+	if (gain==GAIN_ONE)
+		return temp;
+	val=(int32_t)temp*gain;
+	return TMP117Convert::saturate((val+(1L<<13)-(val<0))>>14);
+}	// apply
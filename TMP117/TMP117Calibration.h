@@ -0,0 +1,61 @@
+#ifndef _TMP117_CALIBRATION_
+#define _TMP117_CALIBRATION_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "TMP117.h"
+
+/* *********************************************************************
+ * calibration against a reference
+ *
+ * corrected = gain * measured + offset, fitted by least squares over
+ * reference / measurement pairs in IQ9.7 (gain in Q2.14).
+ * The offset (divided by the gain) is moved to the offset register of
+ * the chip, only a gain != 1 needs to be applied in software.
+ * gain and date code are stored in EEPROM_POS_1 and EEPROM_POS_2,
+ * EEPROM_POS_3 holds the CRC16 profile signature of init(...,persist)
+ * and is not written.
+ * ********************************************************************* */
+
+class TMP117Calibration
+{
+	public:
+		static const int16_t	GAIN_ONE		=16384;		// Q2.14
+		static const TMP117::eeprom_pos_et	EEPROM_GAIN		=TMP117::EEPROM_POS_1;
+		static const TMP117::eeprom_pos_et	EEPROM_DATE		=TMP117::EEPROM_POS_2;
+	
+		TMP117Calibration(TMP117 & sensor);
+		
+		void reset(void);								// discard collected points
+		void addPoint(int16_t reference, int16_t measured);	// IQ9.7
+		bool addPoint(int16_t reference);				// measured value is read from sensor, 
+														// false on bus error
+		uint8_t getPoints(void);
+		
+		bool compute(bool slope=false);					// offset only or offset and gain, 
+														// false if points are insufficient
+		int16_t getOffset(void);						// IQ9.7
+		int16_t getGain(void);							// Q2.14
+		
+		bool commit(uint16_t dateCode);					// queue offset register and metadata to EEPROM,
+														// false on bus error
+		bool load(void);								// read gain and date code from EEPROM,
+														// false on bus error
+		uint16_t getDateCode(void);
+		
+		int16_t apply(int16_t temp);					// software gain correction of IQ9.7 sample
+		
+	private:
+		TMP117 &	sensor;
+		uint8_t		n;
+		int32_t		sum_x;						// measured
+		int32_t		sum_y;						// reference
+		int64_t		sum_xx;
+		int64_t		sum_xy;
+		
+		int16_t		offset;
+		int16_t		gain;
+		uint16_t	date_code;
+};
+
+#endif // _TMP117_CALIBRATION_
@@ -0,0 +1,183 @@
+#ifndef _TMP117_CONVERT_
+#define _TMP117_CONVERT_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* *********************************************************************
+ * fixed point conversion between IQ9.7 and decimal fixed point
+ *
+ * the number of decimals is a template parameter, each conversion is 
+ * a single multiplication (IQ->dec) or division by a constant (dec->IQ)
+ * with rounding half away from zero and saturation to int16_t.
+ * INT16_MIN and INT16_MAX mark saturated values and are passed through
+ *
+ * the wide path converts IQ9.7 to int32_t in °C, °F or K scaled by any
+ * factor up to 10^6 (e.g. 1000: milli degrees). Unit, scale and the
+ * rounding are folded into one multiplication and one shift computed 
+ * by the compiler. Differences (offsets) are converted without the
+ * zero point of the unit. INT32_MIN and INT32_MAX mark saturated values.
+ * ********************************************************************* */
+
+class TMP117Convert
+{
+	public:
+	
+		static const uint8_t	MAX_DECIMALS	=4;
+		static const uint8_t	IQ_SHIFT		=7;	// IQ9.7
+		static const int32_t	MAX_SCALE		=1000000;
+		
+		typedef enum:uint8_t {	UNIT_CELSIUS,
+								UNIT_FAHRENHEIT,
+								UNIT_KELVIN
+								} unit_et;
+	
+		template<uint8_t DECIMALS> struct pow10_s 
+		{	static const int32_t value=10*pow10_s<DECIMALS-1>::value;
+		};
+	
+		template<uint8_t DECIMALS> static inline int16_t toDec(int16_t valIQ)
+		{	// toDec
+			static_assert(DECIMALS<=MAX_DECIMALS,"too many decimals for int16_t");
+			int32_t val=(int32_t)valIQ*pow10_s<DECIMALS>::value;
+			// round half away from zero, arithmetic shift
+			val=(val+(1L<<(IQ_SHIFT-1))-(val<0))>>IQ_SHIFT;
+			if ((valIQ==INT16_MIN) || (valIQ==INT16_MAX))
+				return valIQ;
+			return saturate(val);
+		}	// toDec
+		
+		template<uint8_t DECIMALS> static constexpr int16_t toIQ(int16_t valDec)
+		{	// toIQ, also evaluated by the compiler (TMP117Profile)
+			static_assert(DECIMALS<=MAX_DECIMALS,"too many decimals for int16_t");
+			// round half away from zero, division truncates towards zero
+			return	((valDec==INT16_MIN) || (valDec==INT16_MAX))?(valDec):
+					(saturate(	((int32_t)valDec*((int32_t)1<<IQ_SHIFT)+
+								((valDec<0)?(-pow10_s<DECIMALS>::value/2):(pow10_s<DECIMALS>::value/2)))/
+								pow10_s<DECIMALS>::value));
+		}	// toIQ
+		
+		template<uint8_t DECIMALS> static void toDec(const int16_t * valIQ, int16_t * valDec, size_t count)
+		{	// toDec, bulk
+			for (size_t n=0; n<count; n++)
+				valDec[n]=toDec<DECIMALS>(valIQ[n]);
+		}	// toDec, bulk
+		
+		template<uint8_t DECIMALS> static void toIQ(const int16_t * valDec, int16_t * valIQ, size_t count)
+		{	// toIQ, bulk
+			for (size_t n=0; n<count; n++)
+				valIQ[n]=toIQ<DECIMALS>(valDec[n]);
+		}	// toIQ, bulk
+		
+		static constexpr int64_t div_round(int64_t num, int64_t den)
+		{	// div_round, den>0, half away from zero
+			return (num+((num<0)?(-den/2):(den/2)))/den;
+		}	// div_round
+		
+		static constexpr bool wide_fits(int64_t num, int64_t den, int64_t zero_num, int64_t zero_den, uint8_t shift)
+		{	// wide_fits, largest product incl. zero point and rounding fits int32_t
+			return	div_round(num<<shift,den)*32768+div_round(zero_num<<shift,zero_den)+
+					((int64_t)1<<shift)<=INT32_MAX;
+		}	// wide_fits
+		
+		static constexpr uint8_t wide_shift(int64_t num, int64_t den, int64_t zero_num, int64_t zero_den, uint8_t shift)
+		{	// wide_shift, largest shift that fits
+			return	((shift==0) || wide_fits(num,den,zero_num,zero_den,shift))?
+					(shift):(wide_shift(num,den,zero_num,zero_den,shift-1));
+		}	// wide_shift
+		
+		template<unit_et UNIT, int32_t SCALE, bool DELTA=false> struct wide_s
+		{	// value = (valIQ * MUL + ADD) >> SHIFT
+			static_assert((SCALE>0) && (SCALE<=MAX_SCALE),"scale out of range");
+			// value = valIQ * NUM / DEN + ZERO_NUM / ZERO_DEN
+			static const int64_t	NUM			=(int64_t)SCALE*((UNIT==UNIT_FAHRENHEIT)?(9):(5));
+			static const int64_t	DEN			=(int64_t)5<<IQ_SHIFT;
+			static const int64_t	ZERO_NUM	=(DELTA)?(0):
+												 (int64_t)SCALE*((UNIT==UNIT_FAHRENHEIT)?(3200):
+																 (UNIT==UNIT_KELVIN)?(27315):(0));
+			static const int64_t	ZERO_DEN	=100;
+			static const uint8_t	SHIFT		=wide_shift(NUM,DEN,ZERO_NUM,ZERO_DEN,24);
+			static const int32_t	MUL			=(int32_t)div_round(NUM<<SHIFT,DEN);
+			static const int32_t	ADD			=(int32_t)div_round(ZERO_NUM<<SHIFT,ZERO_DEN);
+			static_assert(wide_fits(NUM,DEN,ZERO_NUM,ZERO_DEN,SHIFT),"scale too large for int32_t");
+		};
+		
+		template<unit_et UNIT, int32_t SCALE> static inline int32_t toWide(int16_t valIQ)
+		{	// toWide
+			typedef wide_s<UNIT,SCALE> k;
+			if ((valIQ==INT16_MIN) || (valIQ==INT16_MAX))
+				return (valIQ==INT16_MIN)?(INT32_MIN):(INT32_MAX);
+			return round_shift((int32_t)valIQ*k::MUL+k::ADD,k::SHIFT);
+		}	// toWide
+		
+		template<unit_et UNIT, int32_t SCALE> static inline int32_t toWideDelta(int16_t valIQ)
+		{	// toWideDelta
+			typedef wide_s<UNIT,SCALE,true> k;
+			if ((valIQ==INT16_MIN) || (valIQ==INT16_MAX))
+				return (valIQ==INT16_MIN)?(INT32_MIN):(INT32_MAX);
+			return round_shift((int32_t)valIQ*k::MUL,k::SHIFT);
+		}	// toWideDelta
+		
+		template<unit_et UNIT, int32_t SCALE> static inline int16_t fromWide(int32_t val)
+		{	// fromWide
+			typedef wide_s<UNIT,SCALE> k;
+			if ((val==INT32_MIN) || (val==INT32_MAX))
+				return (val==INT32_MIN)?(INT16_MIN):(INT16_MAX);
+			return saturate(div_round(((int64_t)val*k::ZERO_DEN-k::ZERO_NUM)*k::DEN,k::NUM*k::ZERO_DEN));
+		}	// fromWide
+		
+		template<unit_et UNIT, int32_t SCALE> static inline int16_t fromWideDelta(int32_t val)
+		{	// fromWideDelta
+			typedef wide_s<UNIT,SCALE,true> k;
+			if ((val==INT32_MIN) || (val==INT32_MAX))
+				return (val==INT32_MIN)?(INT16_MIN):(INT16_MAX);
+			return saturate(div_round((int64_t)val*k::DEN,k::NUM));
+		}	// fromWideDelta
+		
+		template<unit_et UNIT, int32_t SCALE> static void toWide(const int16_t * valIQ, int32_t * val, size_t count)
+		{	// toWide, bulk
+			for (size_t n=0; n<count; n++)
+				val[n]=toWide<UNIT,SCALE>(valIQ[n]);
+		}	// toWide, bulk
+		
+		template<unit_et UNIT, int32_t SCALE> static void toWideDelta(const int16_t * valIQ, int32_t * val, size_t count)
+		{	// toWideDelta, bulk
+			for (size_t n=0; n<count; n++)
+				val[n]=toWideDelta<UNIT,SCALE>(valIQ[n]);
+		}	// toWideDelta, bulk
+		
+		template<unit_et UNIT, int32_t SCALE> static void fromWide(const int32_t * val, int16_t * valIQ, size_t count)
+		{	// fromWide, bulk
+			for (size_t n=0; n<count; n++)
+				valIQ[n]=fromWide<UNIT,SCALE>(val[n]);
+		}	// fromWide, bulk
+		
+		template<unit_et UNIT, int32_t SCALE> static void fromWideDelta(const int32_t * val, int16_t * valIQ, size_t count)
+		{	// fromWideDelta, bulk
+			for (size_t n=0; n<count; n++)
+				valIQ[n]=fromWideDelta<UNIT,SCALE>(val[n]);
+		}	// fromWideDelta, bulk
+		
+		static inline int32_t round_shift(int32_t val, uint8_t shift)
+		{	// round_shift, half away from zero, arithmetic shift
+			return (shift)?((val+(1L<<(shift-1))-(val<0))>>shift):(val);
+		}	// round_shift
+		
+		static constexpr int16_t saturate(int32_t val)
+		{	// saturate
+			return 	(val>INT16_MAX) ? (INT16_MAX) : 
+					(val<INT16_MIN) ? (INT16_MIN) : ((int16_t)val);
+		}	// saturate
+		
+		static inline int16_t saturate(int64_t val)
+		{	// saturate, wide
+			return 	(val>INT16_MAX) ? (INT16_MAX) : 
+					(val<INT16_MIN) ? (INT16_MIN) : ((int16_t)val);
+		}	// saturate, wide
+};
+
+template<> struct TMP117Convert::pow10_s<0> 
+{	static const int32_t value=1;
+};
+
+#endif // _TMP117_CONVERT_
@@ -0,0 +1,187 @@
+#include <Arduino.h>
+#include "TMP117DutyCycle.h"
+
+TMP117DutyCycle::TMP117DutyCycle(TMP117 & sensor) : sensor(sensor)
+{	// constructor
+	running=false;
+	interval=1000;
+	pullup=DEFAULT_PULLUP;
+	clock=DEFAULT_CLOCK;
+	averaging=TMP117::AVERAGING_OFF;
+	handle=TMP117::TRANSACTION_INVALID;
+	start=0;
+	next_start=0;
+	last_account=0;
+	temp=0;
+	timestamp=0;
+	fresh=false;
+	samples=0;
+	missed=0;
+	sensor_charge=0;
+	bus_charge=0;
+}	// constructor
+
+bool TMP117DutyCycle::begin(uint32_t interval, uint32_t budget, uint16_t pullup, uint32_t clock)
+{	// begin
+	bool fits=false;
+	this->interval=interval;
+	this->pullup=pullup;
+	this->clock=clock;
+	averaging=TMP117::AVERAGING_OFF;
+	// highest averaging mode fitting into interval and budget
+	for (uint8_t mode=TMP117::AVERAGING_OFF; mode<=TMP117::AVERAGING_64; mode++)
+		if (	(TMP117::getMeasurementTime((TMP117::averaging_mode_et)mode)<interval) &&
+				(estimateCurrent((TMP117::averaging_mode_et)mode,interval,pullup,clock)<=budget))
+		{	// fits
+			averaging=(TMP117::averaging_mode_et)mode;
+			fits=true;
+		}	// fits
+	sensor.beginConfig();
+	sensor.setAveragingMode(averaging);
+	sensor.setConversionMode(TMP117::MODE_SHUTDOWN);
+	sensor.commitConfig();
+	
+	handle=TMP117::TRANSACTION_INVALID;
+	next_start=millis();
+	last_account=next_start;
+	fresh=false;
+	samples=0;
+	missed=0;
+	sensor_charge=0;
+	bus_charge=0;
+	running=true;
+	return fits;
+}	// begin
+
+void TMP117DutyCycle::end(void)							// stop, sensor stays in shutdown
+{	// end
+	running=false;
+}	// end
+
+bool TMP117DutyCycle::process_idle(void)				// start and collect measurements, true if idle
+{	// process_idle
+	uint32_t now=millis();
+	bool idle=true;
+	if (handle!=TMP117::TRANSACTION_INVALID)
+	{	// measurement pending
+		uint16_t data;
+		sensor.process_idle();
+		if (sensor.isTransactionDone(handle))
+		{	// collect
+			uint32_t active=TMP117::getConversionDuration(averaging);
+			if (sensor.getTransactionResult(handle,data))
+			{	// valid sample
+				temp=data;
+				timestamp=start;
+				fresh=true;
+				samples++;
+			}	// valid sample
+			else
+				missed++;
+			handle=TMP117::TRANSACTION_INVALID;
+			// nA * ms = pC, shutdown current outside of the conversion
+			if ((now-last_account)>active)
+				sensor_charge+=(uint64_t)TMP117::CURRENT_SHUTDOWN_NA*(now-last_account-active);
+			sensor_charge+=(uint64_t)TMP117::CURRENT_ACTIVE_NA*active;
+			bus_charge+=bus_charge_pc(pullup,clock);
+			last_account=now;
+		}	// collect
+		idle=false;
+	}	// measurement pending
+	else if (running && ((int32_t)(now-next_start)>=0))
+	{	// start next measurement
+		handle=sensor.requestMeasurement();
+		if (handle==TMP117::TRANSACTION_INVALID)
+			// queue full, no conversion started
+			missed++;
+		start=now;
+		next_start+=interval;
+		if ((int32_t)(now-next_start)>=0)
+		{	// late, skip missed intervals
+			missed+=(now-next_start)/interval+1;
+			next_start=now+interval;
+		}	// late, skip missed intervals
+		idle=false;
+	}	// start next measurement
+	return idle;
+}	// process_idle
+
+uint32_t TMP117DutyCycle::getNextWake(void)				// millis() when process_idle has work
+{	// getNextWake
+	return (handle!=TMP117::TRANSACTION_INVALID)?(sensor.getMeasurementDeadline()):(next_start);
+}	// getNextWake
+
+bool TMP117DutyCycle::available(void)					// new sample since last getTemp
+{	// available
+	return fresh;
+}	// available
+
+int16_t TMP117DutyCycle::getTemp(void)					// last sample in IQ9.7
+{	// getTemp
+	fresh=false;
+	return temp;
+}	// getTemp
+
+uint32_t TMP117DutyCycle::getTimestamp(void)			// ms, start of conversion
+{	// getTimestamp
+	return timestamp;
+}	// getTimestamp
+
+uint32_t TMP117DutyCycle::getSamples(void)
+{	// getSamples
+	return samples;
+}	// getSamples
+
+uint32_t TMP117DutyCycle::getMissed(void)				// intervals skipped (late process_idle, bus error)
+{	// getMissed
+	return missed;
+}	// getMissed
+
+TMP117::averaging_mode_et TMP117DutyCycle::getAveragingMode(void)
+{	// getAveragingMode
+	return averaging;
+}	// getAveragingMode
+
+uint32_t TMP117DutyCycle::getAverageCurrent(void)		// nA, estimate for selected averaging mode
+{	// getAverageCurrent
+	return estimateCurrent(averaging,interval,pullup,clock);
+}	// getAverageCurrent
+
+uint32_t TMP117DutyCycle::getSensorCharge(void)			// µC since begin
+{	// getSensorCharge
+	return sensor_charge/1000000UL;
+}	// getSensorCharge
+
+uint32_t TMP117DutyCycle::getBusCharge(void)			// µC since begin
+{	// getBusCharge
+	return bus_charge/1000000UL;
+}	// getBusCharge
+
+uint32_t TMP117DutyCycle::estimateCurrent(	TMP117::averaging_mode_et mode, uint32_t interval, 
+											uint16_t pullup, uint32_t clock)	// nA
+{	// estimateCurrent
+	uint64_t charge;										// pC per interval
+	uint32_t active=TMP117::getConversionDuration(mode);
+	if (!interval)
+		return UINT32_MAX;
+	if (active>interval)
+		active=interval;
+	charge=	(uint64_t)TMP117::CURRENT_ACTIVE_NA*active+
+			(uint64_t)TMP117::CURRENT_SHUTDOWN_NA*(interval-active)+
+			bus_charge_pc(pullup,clock);
+	// pC / ms = nA
+	return charge/interval;
+}	// estimateCurrent
+
+/* *********************************************************************
+ * private functions
+ * ********************************************************************* */
+
+uint32_t TMP117DutyCycle::bus_charge_pc(uint16_t pullup, uint32_t clock)	// pC per measurement
+{	// bus_charge_pc
+	// trigger and temperature read, SCL is low for half of each clock,
+	// SDA about half of the time: one pull-up current per bit time
+	uint32_t bits=TRIGGER_BITS+TMP117::TEMP_READ_BITS;
+	// µA * µs = pC
+	return (uint32_t)((uint64_t)pullup*bits*1000000UL/clock);
+}	// bus_charge_pc
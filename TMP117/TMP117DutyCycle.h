@@ -0,0 +1,73 @@
+#ifndef _TMP117_DUTY_CYCLE_
+#define _TMP117_DUTY_CYCLE_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "TMP117.h"
+
+/* *********************************************************************
+ * duty cycled one-shot measurements within an energy budget
+ *
+ * the sensor is kept in shutdown and a one-shot conversion is started
+ * every interval. The highest averaging mode whose average current
+ * (sensor and I2C pull-ups) fits the budget is selected. The charge is
+ * accounted from the typical supply currents of the datasheet and the
+ * bus clocks of each measurement.
+ * ********************************************************************* */
+
+class TMP117DutyCycle
+{
+	public:
+		static const uint16_t	DEFAULT_PULLUP	=700;		// µA while a line is low, 3.3V / 4.7k
+		static const uint32_t	DEFAULT_CLOCK	=100000;	// Hz
+		static const uint8_t	TRIGGER_BITS	=38;		// bus clocks to write configuration
+		
+		TMP117DutyCycle(TMP117 & sensor);
+		
+		bool begin(	uint32_t interval, uint32_t budget, 			// ms, average current in nA
+					uint16_t pullup=DEFAULT_PULLUP, uint32_t clock=DEFAULT_CLOCK);	// false if budget too low
+		void end(void);									// stop, sensor stays in shutdown
+		
+		bool process_idle(void);						// start and collect measurements, true if idle
+		uint32_t getNextWake(void);						// millis() when process_idle has work
+		
+		bool available(void);							// new sample since last getTemp
+		int16_t getTemp(void);							// last sample in IQ9.7
+		uint32_t getTimestamp(void);					// ms, start of conversion
+		uint32_t getSamples(void);
+		uint32_t getMissed(void);						// intervals skipped (late process_idle, bus error, queue full)
+		
+		TMP117::averaging_mode_et getAveragingMode(void);
+		uint32_t getAverageCurrent(void);				// nA, estimate for selected averaging mode
+		uint32_t getSensorCharge(void);					// µC since begin
+		uint32_t getBusCharge(void);					// µC since begin
+		
+		static uint32_t estimateCurrent(TMP117::averaging_mode_et mode, uint32_t interval, 
+										uint16_t pullup, uint32_t clock);	// nA
+		
+	private:
+		TMP117 &		sensor;
+		bool			running;
+		uint32_t		interval;
+		uint16_t		pullup;
+		uint32_t		clock;
+		TMP117::averaging_mode_et	averaging;
+		
+		uint8_t			handle;						// pending measurement
+		uint32_t		start;						// trigger of pending measurement
+		uint32_t		next_start;
+		uint32_t		last_account;				// end of accounted time
+		
+		int16_t			temp;
+		uint32_t		timestamp;
+		bool			fresh;
+		uint32_t		samples;
+		uint32_t		missed;
+		
+		uint64_t		sensor_charge;				// pC
+		uint64_t		bus_charge;					// pC
+		
+		static uint32_t bus_charge_pc(uint16_t pullup, uint32_t clock);	// pC per measurement
+};
+
+#endif // _TMP117_DUTY_CYCLE_
@@ -0,0 +1,229 @@
+#include <Arduino.h>
+#include "TMP117Events.h"
+
+TMP117Events::TMP117Events(TMP117 & sensor) : sensor(sensor)
+{	// constructor
+	threshold=NULL;
+	size=0;
+	window=DEFAULT_WINDOW;
+	valid=false;
+	temp=0;
+	rate=0;
+	ref_temp=0;
+	ref_time=0;
+	ref_valid=false;
+	last_check=0;
+	reads=0;
+}	// constructor
+
+void TMP117Events::begin(threshold_st * storage, uint8_t size, uint16_t window)	// storage provided by application
+{	// begin
+	threshold=storage;
+	this->size=size;
+	this->window=window;
+	for (uint8_t n=0; n<size; n++)
+		threshold[n].callback=NULL;
+	valid=false;
+	ref_valid=false;
+	// limits are compared with every conversion, flags latched until read
+	sensor.beginConfig();
+	sensor.setAlertMode(TMP117::ALERT_MODE_ALERT);
+	sensor.setAlertPinSource(TMP117::ALERT_PIN_ALERT);
+	sensor.commitConfig();
+}	// begin
+
+uint8_t TMP117Events::addLevel(int16_t level, uint16_t hysteresis, uint8_t debounce, event_cb_t callback, void * context)
+{	// addLevel
+	return add(THRESHOLD_LEVEL,level,hysteresis,debounce,callback,context);
+}	// addLevel
+
+uint8_t TMP117Events::addRate(int16_t rate, uint16_t hysteresis, uint8_t debounce, event_cb_t callback, void * context)
+{	// addRate
+	return add(THRESHOLD_RATE,rate,hysteresis,debounce,callback,context);
+}	// addRate
+
+void TMP117Events::remove(uint8_t id)
+{	// remove
+	if (id<size)
+		threshold[id].callback=NULL;
+	if (valid && !isTracking())
+		set_band();
+}	// remove
+
+bool TMP117Events::process_idle(void)
+{	// process_idle
+	bool idle=true;
+	uint32_t now=millis();
+	// the chip compares the limits once per conversion
+	if ((now-last_check)>=sensor.getConversionCycleTime())
+	{	// check due
+		if (isTracking())
+		{	// every sample
+			if (sensor.isDataReady())
+			{	// new result
+				int16_t temp=sensor.getTemp();
+				last_check=now;
+				reads++;
+				if (sensor.isBusOk())
+					update(temp,now);
+				idle=false;
+			}	// new result
+		}	// every sample
+		else
+		{	// wake on limit alert
+			last_check=now;
+			if (sensor.isAlert())
+			{	// level may have been crossed
+				int16_t temp=sensor.getTemp();
+				reads++;
+				if (sensor.isBusOk())
+					update(temp,now);
+				// reading the configuration releases the ALERT pin
+				sensor.readStatus();
+				sensor.clearStatus();
+				idle=false;
+			}	// level may have been crossed
+		}	// wake on limit alert
+	}	// check due
+	return idle;
+}	// process_idle
+
+void TMP117Events::update(int16_t temp, uint32_t timestamp)	// feed sample read elsewhere (IQ9.7, ms)
+{	// update
+	bool tracking=isTracking();
+	this->temp=temp;
+	if (!valid)
+	{	// first sample sets state without events
+		for (uint8_t n=0; n<size; n++)
+		{	// each threshold
+			threshold[n].above=(threshold[n].type==THRESHOLD_LEVEL) && (temp>threshold[n].level);
+			threshold[n].count=0;
+		}	// each threshold
+		valid=true;
+	}	// first sample sets state without events
+	else
+		evaluate(THRESHOLD_LEVEL,temp);
+	
+	if (!tracking || !ref_valid || ((timestamp-ref_time)>=2UL*window))
+	{	// samples not consecutive, restart window
+		ref_temp=temp;
+		ref_time=timestamp;
+		ref_valid=true;
+	}	// samples not consecutive, restart window
+	else if ((timestamp-ref_time)>=window)
+	{	// window complete
+		int32_t r=((int32_t)temp-ref_temp)*1000/(int32_t)(timestamp-ref_time);
+		rate=(r>INT16_MAX)?(INT16_MAX):((r<-INT16_MAX)?(-INT16_MAX):(r));
+		ref_temp=temp;
+		ref_time=timestamp;
+		evaluate(THRESHOLD_RATE,rate);
+	}	// window complete
+	
+	if (!isTracking())
+		set_band();
+}	// update
+
+bool TMP117Events::isAbove(uint8_t id)
+{	// isAbove
+	return (id<size) && threshold[id].callback && threshold[id].above;
+}	// isAbove
+
+bool TMP117Events::isTracking(void)							// every sample is read
+{	// isTracking
+	if (!valid)
+		return true;
+	for (uint8_t n=0; n<size; n++)
+		if (threshold[n].callback && ((threshold[n].type==THRESHOLD_RATE) || threshold[n].count))
+			return true;
+	return false;
+}	// isTracking
+
+int16_t TMP117Events::getTemp(void)
+{	// getTemp
+	return temp;
+}	// getTemp
+
+int16_t TMP117Events::getRate(void)
+{	// getRate
+	return rate;
+}	// getRate
+
+uint32_t TMP117Events::getReads(void)
+{	// getReads
+	return reads;
+}	// getReads
+
+/* *********************************************************************
+ * private functions
+ * ********************************************************************* */
+
+uint8_t TMP117Events::add(	threshold_type_et type, int16_t level, uint16_t hysteresis, uint8_t debounce, 
+							event_cb_t callback, void * context)
+{	// add
+	uint8_t id=0;
+	if (!callback)
+		return INVALID;
+	while ((id<size) && threshold[id].callback)
+		id++;
+	if (id>=size)
+		return INVALID;
+	threshold_st & t=threshold[id];
+	t.type=type;
+	t.level=level;
+	t.hysteresis=hysteresis;
+	t.debounce=debounce;
+	t.context=context;
+	t.count=0;
+	t.above=(type==THRESHOLD_LEVEL)?(valid && (temp>level)):(false);
+	t.callback=callback;
+	if (valid && !isTracking())
+		set_band();
+	return id;
+}	// add
+
+void TMP117Events::evaluate(threshold_type_et type, int16_t value)	// count and dispatch
+{	// evaluate
+	for (uint8_t n=0; n<size; n++)
+	{	// each threshold
+		threshold_st & t=threshold[n];
+		bool beyond;
+		if (!t.callback || (t.type!=type))
+			continue;
+		beyond=(t.above)?((int32_t)value<(int32_t)t.level-t.hysteresis):(value>t.level);
+		if (!beyond)
+			t.count=0;
+		else if (++t.count>=t.debounce)
+		{	// confirmed, change state
+			t.above=!t.above;
+			t.count=0;
+			t.callback(*this,n,(t.above)?(EVENT_ABOVE):(EVENT_BELOW),value,t.context);
+		}	// confirmed, change state
+	}	// each threshold
+}	// evaluate
+
+void TMP117Events::set_band(void)							// limit registers to enclosing levels
+{	// set_band
+	int32_t high=INT16_MAX;
+	int32_t low=INT16_MIN;
+	for (uint8_t n=0; n<size; n++)
+	{	// each level threshold
+		threshold_st & t=threshold[n];
+		if (!t.callback || (t.type!=THRESHOLD_LEVEL))
+			continue;
+		if (t.above)
+		{	// next event below level-hysteresis
+			int32_t l=(int32_t)t.level-t.hysteresis;
+			if (l>low)
+				low=l;
+		}	// next event below level-hysteresis
+		else if (t.level<high)
+			high=t.level;
+	}	// each level threshold
+	// shadow registers, only changed limits are written
+	sensor.beginConfig();
+	if (sensor.getHighTemperaturLimit()!=high)
+		sensor.setHighTemperaturLimit((int16_t)high);
+	if (sensor.getLowTemperaturLimit()!=(int16_t)low)
+		sensor.setLowTemperaturLimit((int16_t)low);
+	sensor.commitConfig();
+}	// set_band
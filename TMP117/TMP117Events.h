@@ -0,0 +1,83 @@
+#ifndef _TMP117_EVENTS_
+#define _TMP117_EVENTS_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "TMP117.h"
+
+/* *********************************************************************
+ * software thresholds with hysteresis, debounce and rate of change
+ *
+ * a threshold is above after its value exceeded level and below after
+ * it fell under level-hysteresis, each change is reported by callback
+ * after debounce consecutive samples. The limit registers of the chip
+ * are set to the nearest level thresholds enclosing the temperature,
+ * samples are read only after an alert unless a threshold needs every
+ * sample (rate of change, debounce in progress).
+ * ********************************************************************* */
+
+class TMP117Events
+{
+	public:
+		static const uint8_t	INVALID			=0xFF;		// id returned if storage is full
+		static const uint16_t	DEFAULT_WINDOW	=1000;		// ms, time base for rate of change
+		
+		typedef enum:uint8_t {	THRESHOLD_LEVEL,			// temperature in IQ9.7
+								THRESHOLD_RATE				// rate of change in IQ9.7 per second
+								} threshold_type_et;
+		
+		typedef enum:uint8_t {	EVENT_ABOVE,				// value exceeded level
+								EVENT_BELOW					// value fell below level-hysteresis
+								} event_et;
+		
+		typedef void (*event_cb_t)(TMP117Events & events, uint8_t id, event_et event, int16_t value, void * context);
+		
+		typedef struct threshold_s {	event_cb_t			callback;		// NULL: unused
+										void *				context;
+										int16_t				level;
+										uint16_t			hysteresis;
+										threshold_type_et	type;
+										uint8_t				debounce;		// samples, 0 and 1 are immediate
+										bool				above;
+										uint8_t				count;			// samples beyond level / hysteresis
+									}	threshold_st;
+		
+		TMP117Events(TMP117 & sensor);
+		
+		void begin(threshold_st * storage, uint8_t size, uint16_t window=DEFAULT_WINDOW);	// storage provided by application
+		
+		uint8_t addLevel(int16_t level, uint16_t hysteresis, uint8_t debounce, event_cb_t callback, void * context=NULL);
+		uint8_t addRate(int16_t rate, uint16_t hysteresis, uint8_t debounce, event_cb_t callback, void * context=NULL);
+		void remove(uint8_t id);
+		
+		bool process_idle(void);						// reads temperature when needed, true if idle
+		void update(int16_t temp, uint32_t timestamp);	// feed sample read elsewhere (IQ9.7, ms)
+		
+		bool isAbove(uint8_t id);
+		bool isTracking(void);							// every sample is read
+		int16_t getTemp(void);							// last sample in IQ9.7
+		int16_t getRate(void);							// last rate of change in IQ9.7 per second
+		uint32_t getReads(void);						// temperature reads by process_idle
+		
+	private:
+		TMP117 &		sensor;
+		threshold_st *	threshold;
+		uint8_t			size;
+		uint16_t		window;
+		
+		bool			valid;						// first sample taken
+		int16_t			temp;
+		int16_t			rate;
+		int16_t			ref_temp;					// start of rate window
+		uint32_t		ref_time;
+		bool			ref_valid;
+		uint32_t		last_check;					// ms
+		uint32_t		reads;
+		
+		uint8_t add(threshold_type_et type, int16_t level, uint16_t hysteresis, uint8_t debounce, event_cb_t callback, void * context);
+		void evaluate(threshold_type_et type, int16_t value);	// count and dispatch
+		void set_band(void);						// limit registers to enclosing levels
+};
+
+#endif // _TMP117_EVENTS_
@@ -0,0 +1,150 @@
+#include <Arduino.h>
+#include "TMP117Governor.h"
+
+const TMP117Governor::policy_st TMP117Governor::DEFAULT_POLICY={
+	{TMP117::CONVERSION_TIME_1s,	TMP117::AVERAGING_64},
+	{TMP117::CONVERSION_TIME_1_64s,	TMP117::AVERAGING_OFF},
+	32,					// 0.25°C/s
+	13,					// 0.1°C/s
+	1000,
+	4
+};
+
+TMP117Governor::TMP117Governor(TMP117 & sensor) : sensor(sensor)
+{	// constructor
+	policy=DEFAULT_POLICY;
+	profile=PROFILE_SLOW;
+	temp=0;
+	rate=0;
+	ref_temp=0;
+	ref_time=0;
+	ref_valid=false;
+	hold=0;
+	last_sample=0;
+	profile_start=0;
+	slow_time=0;
+}	// constructor
+
+void TMP117Governor::begin(const policy_st & policy)	// applies slow profile
+{	// begin
+	this->policy=policy;
+	// savings are counted from begin, not from power up
+	slow_time=0;
+	profile_start=millis();
+	apply(PROFILE_SLOW);
+}	// begin
+
+bool TMP117Governor::process_idle(void)
+{	// process_idle
+	bool idle=true;
+	uint32_t now=millis();
+	// poll status only when a new result is expected
+	if (((now-last_sample)>=sensor.getConversionCycleTime()) && sensor.isDataReady())
+	{	// new result
+		int16_t temp=sensor.getTemp();
+		if (sensor.isBusOk())
+			update(temp,now);
+		idle=false;
+	}	// new result
+	return idle;
+}	// process_idle
+
+void TMP117Governor::update(int16_t temp, uint32_t timestamp)	// feed sample read elsewhere (IQ9.7, ms)
+{	// update
+	this->temp=temp;
+	last_sample=timestamp;
+	if (!ref_valid)
+	{	// start window
+		ref_temp=temp;
+		ref_time=timestamp;
+		ref_valid=true;
+	}	// start window
+	else if ((timestamp-ref_time)>=policy.window)
+	{	// window complete
+		int32_t delta=(int32_t)temp-ref_temp;
+		int32_t r=delta*1000/(int32_t)(timestamp-ref_time);
+		uint16_t magnitude;
+		rate=(r>INT16_MAX)?(INT16_MAX):((r<-INT16_MAX)?(-INT16_MAX):(r));
+		magnitude=(rate<0)?(-rate):(rate);
+		ref_temp=temp;
+		ref_time=timestamp;
+		
+		if (magnitude>policy.enterRate)
+		{	// transient
+			hold=0;
+			if (profile==PROFILE_SLOW)
+				apply(PROFILE_FAST);
+		}	// transient
+		else if ((profile==PROFILE_FAST) && (magnitude<policy.exitRate))
+		{	// stable, switch after hysteresis
+			if (++hold>=policy.holdWindows)
+				apply(PROFILE_SLOW);
+		}	// stable
+		else
+			hold=0;
+	}	// window complete
+}	// update
+
+TMP117Governor::profile_et TMP117Governor::getProfile(void)
+{	// getProfile
+	return profile;
+}	// getProfile
+
+int16_t TMP117Governor::getTemp(void)
+{	// getTemp
+	return temp;
+}	// getTemp
+
+int16_t TMP117Governor::getRate(void)
+{	// getRate
+	return rate;
+}	// getRate
+
+uint32_t TMP117Governor::getSavedReads(void)				// compared to running the fast profile only
+{	// getSavedReads
+	uint32_t ms=slow_ms();
+	return	ms/TMP117::getConversionCycleTime(policy.fast.time,policy.fast.averaging)-
+			ms/TMP117::getConversionCycleTime(policy.slow.time,policy.slow.averaging);
+}	// getSavedReads
+
+uint32_t TMP117Governor::getSavedBusTime(uint32_t clock)	// µs at given I2C clock
+{	// getSavedBusTime
+	// every sample is a data ready poll and the temperature read
+	return (uint32_t)((uint64_t)getSavedReads()*(TMP117::STATUS_READ_BITS+TMP117::TEMP_READ_BITS)*1000000UL/clock);
+}	// getSavedBusTime
+
+uint32_t TMP117Governor::getSavedCharge(void)				// sensor charge in µC
+{	// getSavedCharge
+	int32_t current=	(int32_t)TMP117::getSupplyCurrent(policy.fast.time,policy.fast.averaging)-
+						(int32_t)TMP117::getSupplyCurrent(policy.slow.time,policy.slow.averaging);
+	// nA * ms = pC
+	return (current>0)?((uint32_t)((uint64_t)current*slow_ms()/1000000UL)):(0);
+}	// getSavedCharge
+
+/* *********************************************************************
+ * private functions
+ * ********************************************************************* */
+
+void TMP117Governor::apply(profile_et profile)
+{	// apply
+	const profile_st & p=(profile==PROFILE_FAST)?(policy.fast):(policy.slow);
+	uint32_t now=millis();
+	if (this->profile==PROFILE_SLOW)
+		slow_time+=now-profile_start;
+	profile_start=now;
+	this->profile=profile;
+	sensor.beginConfig();
+	sensor.setConversionTime(p.time);
+	sensor.setAveragingMode(p.averaging);
+	sensor.commitConfig();
+	// conversion restarted, no result before a full cycle
+	last_sample=now;
+	// averaging changed, start a new window
+	ref_valid=false;
+	hold=0;
+}	// apply
+
+uint32_t TMP117Governor::slow_ms(void)						// total time in slow profile
+{	// slow_ms
+	return (profile==PROFILE_SLOW)?(slow_time+(millis()-profile_start)):(slow_time);
+}	// slow_ms
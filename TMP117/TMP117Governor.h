@@ -0,0 +1,74 @@
+#ifndef _TMP117_GOVERNOR_
+#define _TMP117_GOVERNOR_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "TMP117.h"
+
+/* *********************************************************************
+ * adaptive conversion rate and averaging
+ *
+ * the rate of change is measured over a time window, above enterRate
+ * the sensor is switched to the fast profile, after holdWindows windows
+ * below exitRate back to the slow profile
+ * ********************************************************************* */
+
+class TMP117Governor
+{
+	public:
+	
+		typedef enum:uint8_t {	PROFILE_SLOW,
+								PROFILE_FAST
+								} profile_et;
+		
+		typedef struct profile_s {	TMP117::conversion_time_et	time;
+									TMP117::averaging_mode_et	averaging;
+								 }	profile_st;
+		
+		typedef struct policy_s {	profile_st	slow;
+									profile_st	fast;
+									uint16_t	enterRate;		// IQ9.7 per second, switch to fast above
+									uint16_t	exitRate;		// IQ9.7 per second, switch to slow below
+									uint16_t	window;			// ms, time base for rate of change
+									uint8_t		holdWindows;	// windows below exitRate before switching to slow
+								}	policy_st;
+		
+		static const policy_st	DEFAULT_POLICY;	// 1s/64x, 1/64s/no averaging, 0.25°C/s, 0.1°C/s
+		
+		TMP117Governor(TMP117 & sensor);
+		
+		void begin(const policy_st & policy=DEFAULT_POLICY);	// applies slow profile
+		
+		bool process_idle(void);						// reads temperature when due, true if idle
+		void update(int16_t temp, uint32_t timestamp);	// feed sample read elsewhere (IQ9.7, ms)
+		
+		profile_et getProfile(void);
+		int16_t getTemp(void);							// last sample in IQ9.7
+		int16_t getRate(void);							// last rate of change in IQ9.7 per second
+		
+		uint32_t getSavedReads(void);					// compared to running the fast profile only
+		uint32_t getSavedBusTime(uint32_t clock);		// µs at given I2C clock
+		uint32_t getSavedCharge(void);					// sensor charge in µC
+		
+	private:
+	
+		TMP117 &		sensor;
+		policy_st		policy;
+		profile_et		profile;
+		
+		int16_t			temp;
+		int16_t			rate;
+		int16_t			ref_temp;					// start of rate window
+		uint32_t		ref_time;
+		bool			ref_valid;
+		uint8_t			hold;
+		
+		uint32_t		last_sample;				// ms
+		uint32_t		profile_start;				// ms
+		uint32_t		slow_time;					// ms spent in slow profile, finished periods
+		
+		void apply(profile_et profile);
+		uint32_t slow_ms(void);						// total time in slow profile
+};
+
+#endif // _TMP117_GOVERNOR_
@@ -0,0 +1,210 @@
+#include "TMP117History.h"
+
+uint8_t TMP117History::zigzag(int32_t val, uint8_t * buffer)	// returns length of varint
+{	// zigzag
+	uint32_t zz=((uint32_t)val<<1)^(uint32_t)(val>>31);
+	uint8_t len=0;
+	while (zz>=0x80)
+	{	// 7 bit groups
+		buffer[len++]=(zz&0x7F)|0x80;
+		zz>>=7;
+	}	// 7 bit groups
+	buffer[len++]=zz;
+	return len;
+}	// zigzag
+
+uint8_t TMP117History::unzigzag(const uint8_t * buffer, size_t len, int32_t & val)	// returns used bytes, 0 on error
+{	// unzigzag
+	uint32_t zz=0;
+	uint8_t n=0;
+	do
+	{	// 7 bit groups
+		if ((n>=len) || (n>=5))
+			return 0;
+		zz|=(uint32_t)(buffer[n]&0x7F)<<(7*n);
+	}	while (buffer[n++]&0x80);
+	val=(int32_t)(zz>>1)^-(int32_t)(zz&1);
+	return n;
+}	// unzigzag
+
+/* *********************************************************************
+ * writer
+ * ********************************************************************* */
+
+TMP117HistoryWriter::TMP117HistoryWriter(void)
+{	// constructor
+	buffer=NULL;
+	size=0;
+	length=0;
+	samples=0;
+	records=0;
+	keyframe=64;
+	last=0;
+}	// constructor
+
+bool TMP117HistoryWriter::begin(uint8_t * buffer, size_t size, uint16_t interval, 
+								uint32_t start, uint8_t keyframe)	// interval and start in ms
+{	// begin
+	if (!buffer || (size<TMP117History::HEADER_SIZE) || !keyframe)
+		return false;
+	this->buffer=buffer;
+	this->size=size;
+	this->keyframe=keyframe;
+	samples=0;
+	records=0;
+	last=0;
+	buffer[0]='T';
+	buffer[1]='H';
+	buffer[2]=TMP117History::VERSION;
+	buffer[3]=keyframe;
+	buffer[4]=interval&0xFF;
+	buffer[5]=interval>>8;
+	for (uint8_t n=0; n<4; n++)
+		buffer[6+n]=(start>>(8*n))&0xFF;
+	length=TMP117History::HEADER_SIZE;
+	return true;
+}	// begin
+
+bool TMP117HistoryWriter::append(int16_t temp)			// IQ9.7, false if buffer is full
+{	// append
+	uint8_t record[TMP117History::MAX_RECORD_SIZE];
+	uint8_t len;
+	if (!buffer)
+		return false;
+	// a raw keyframe could look like the gap escape
+	len=TMP117History::zigzag((records%keyframe)?((int32_t)temp-last):(temp),record);
+	if (length+len>size)
+		return false;
+	for (uint8_t n=0; n<len; n++)
+		buffer[length++]=record[n];
+	last=temp;
+	records++;
+	samples++;
+	return true;
+}	// append
+
+bool TMP117HistoryWriter::skip(uint16_t count)			// mark missing samples, keeps timestamps
+{	// skip
+	uint8_t record[2+TMP117History::MAX_RECORD_SIZE];
+	uint8_t len;
+	if (!buffer)
+		return false;
+	if (!count)
+		return true;
+	record[0]=0x80;
+	record[1]=0x00;
+	len=2+TMP117History::zigzag(count,record+2);
+	if (length+len>size)
+		return false;
+	for (uint8_t n=0; n<len; n++)
+		buffer[length++]=record[n];
+	samples+=count;
+	return true;
+}	// skip
+
+size_t TMP117HistoryWriter::getLength(void)				// bytes used incl. header
+{	// getLength
+	return length;
+}	// getLength
+
+uint32_t TMP117HistoryWriter::getSamples(void)			// samples incl. skipped ones
+{	// getSamples
+	return samples;
+}	// getSamples
+
+/* *********************************************************************
+ * reader
+ * ********************************************************************* */
+
+TMP117HistoryReader::TMP117HistoryReader(void)
+{	// constructor
+	buffer=NULL;
+	length=0;
+	pos=0;
+	error=false;
+}	// constructor
+
+bool TMP117HistoryReader::begin(const uint8_t * buffer, size_t length)	// false if header is invalid
+{	// begin
+	this->buffer=buffer;
+	this->length=length;
+	error=	!buffer || (length<TMP117History::HEADER_SIZE) ||
+			(buffer[0]!='T') || (buffer[1]!='H') ||
+			(buffer[2]!=TMP117History::VERSION) || !buffer[3];
+	if (error)
+		return false;
+	keyframe=buffer[3];
+	interval=buffer[4]|((uint16_t)buffer[5]<<8);
+	start=0;
+	for (uint8_t n=0; n<4; n++)
+		start|=(uint32_t)buffer[6+n]<<(8*n);
+	pos=TMP117History::HEADER_SIZE;
+	samples=0;
+	records=0;
+	last=0;
+	return true;
+}	// begin
+
+bool TMP117HistoryReader::next(int16_t & temp, uint32_t & timestamp)	// false at end of data or on error
+{	// next
+	int32_t val;
+	uint8_t used;
+	
+	if (error || !buffer)
+		return false;
+	while ((pos+1<length) && (buffer[pos]==0x80) && (buffer[pos+1]==0x00))
+	{	// gap
+		used=TMP117History::unzigzag(buffer+pos+2,length-pos-2,val);
+		if (!used || (val<=0))
+		{	// corrupt
+			error=true;
+			return false;
+		}	// corrupt
+		samples+=val;
+		pos+=2+used;
+	}	// gap
+	if (pos>=length)
+		return false;
+	used=TMP117History::unzigzag(buffer+pos,length-pos,val);
+	if (!used)
+	{	// truncated
+		error=true;
+		return false;
+	}	// truncated
+	// absolute value or difference
+	last=(records%keyframe)?((int16_t)(last+val)):((int16_t)val);
+	pos+=used;
+	temp=last;
+	timestamp=start+samples*interval;
+	records++;
+	samples++;
+	return true;
+}	// next
+
+size_t TMP117HistoryReader::decode(int16_t * temp, uint32_t * timestamp, size_t max)	// bulk, timestamp may be NULL
+{	// decode
+	size_t n=0;
+	uint32_t ts;
+	while ((n<max) && next(temp[n],ts))
+	{	// decode
+		if (timestamp)
+			timestamp[n]=ts;
+		n++;
+	}	// decode
+	return n;
+}	// decode
+
+uint16_t TMP117HistoryReader::getInterval(void)			// ms
+{	// getInterval
+	return interval;
+}	// getInterval
+
+uint32_t TMP117HistoryReader::getStart(void)			// ms
+{	// getStart
+	return start;
+}	// getStart
+
+bool TMP117HistoryReader::isError(void)					// corrupt data found
+{	// isError
+	return error;
+}	// isError
@@ -0,0 +1,84 @@
+#ifndef _TMP117_HISTORY_
+#define _TMP117_HISTORY_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* *********************************************************************
+ * compact history of IQ9.7 samples
+ *
+ * header (10 bytes, little endian)
+ *   'T' 'H' version keyframe_interval interval_ms(2) start_ms(4)
+ * records
+ *   every keyframe_interval records the absolute sample, in between the
+ *   difference to the previous sample, both zig-zag encoded as varint
+ *   (7 bit groups, LSB first, bit 7 set if more bytes follow)
+ *   0x80 0x00 (never produced by the varint encoder) escapes a gap, 
+ *   followed by the number of missing samples as varint
+ * timestamps are implicit: start_ms + sample_index * interval_ms
+ * ********************************************************************* */
+
+class TMP117History
+{
+	public:
+		static const uint8_t	HEADER_SIZE		=10;
+		static const uint8_t	VERSION			=2;		// 1: raw keyframes
+		static const uint8_t	MAX_RECORD_SIZE	=3;		// zig-zag of 16 bit value or difference
+		
+		static uint8_t zigzag(int32_t val, uint8_t * buffer);			// returns length of varint
+		static uint8_t unzigzag(const uint8_t * buffer, size_t len, int32_t & val);	// returns used bytes, 0 on error
+};
+
+class TMP117HistoryWriter
+{
+	public:
+		TMP117HistoryWriter(void);
+		
+		bool begin(	uint8_t * buffer, size_t size, uint16_t interval, 
+					uint32_t start, uint8_t keyframe=64);	// interval and start in ms
+		
+		bool append(int16_t temp);					// IQ9.7, false if buffer is full
+		bool skip(uint16_t count);					// mark missing samples, keeps timestamps
+		
+		size_t getLength(void);						// bytes used incl. header
+		uint32_t getSamples(void);					// samples incl. skipped ones
+		
+	private:
+		uint8_t *	buffer;
+		size_t		size;
+		size_t		length;
+		uint32_t	samples;
+		uint32_t	records;
+		uint8_t		keyframe;
+		int16_t		last;
+};
+
+class TMP117HistoryReader
+{
+	public:
+		TMP117HistoryReader(void);
+		
+		bool begin(const uint8_t * buffer, size_t length);	// false if header is invalid
+		
+		bool next(int16_t & temp, uint32_t & timestamp);	// false at end of data or on error
+		size_t decode(int16_t * temp, uint32_t * timestamp, size_t max);	// bulk, timestamp may be NULL
+		
+		uint16_t getInterval(void);					// ms
+		uint32_t getStart(void);					// ms
+		bool isError(void);							// corrupt data found
+		
+	private:
+		const uint8_t *	buffer;
+		size_t			length;
+		size_t			pos;
+		uint32_t		samples;
+		uint32_t		records;
+		uint8_t			keyframe;
+		uint16_t		interval;
+		uint32_t		start;
+		int16_t			last;
+		bool			error;
+};
+
+#endif // _TMP117_HISTORY_
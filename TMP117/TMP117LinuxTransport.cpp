@@ -0,0 +1,148 @@
+#if defined(__linux__)
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+#include "TMP117LinuxTransport.h"
+
+TMP117LinuxTransport::TMP117LinuxTransport(void)
+{	// constructor
+	fd=-1;
+}	// constructor
+
+TMP117LinuxTransport::~TMP117LinuxTransport(void)
+{	// destructor
+	close();
+}	// destructor
+
+TMP117LinuxTransport & TMP117LinuxTransport::getDefault(void)	// not opened
+{	// getDefault
+	static TMP117LinuxTransport transport;
+	return transport;
+}	// getDefault
+
+bool TMP117LinuxTransport::open(const char * device)			// e.g. "/dev/i2c-1"
+{	// open
+	close();
+	fd=::open(device,O_RDWR);
+	return fd>=0;
+}	// open
+
+void TMP117LinuxTransport::close(void)
+{	// close
+	if (fd>=0)
+		::close(fd);
+	fd=-1;
+}	// close
+
+bool TMP117LinuxTransport::isOpen(void)
+{	// isOpen
+	return fd>=0;
+}	// isOpen
+
+bool TMP117LinuxTransport::probe(uint8_t addr)				// address acknowledged
+{	// probe
+	// zero length messages are not supported by all adapters,
+	// a single byte read does not change the pointer register
+	uint8_t buffer;
+	struct i2c_msg msg={addr,I2C_M_RD,1,&buffer};
+	return transfer(&msg,1);
+}	// probe
+
+bool TMP117LinuxTransport::writePointer(uint8_t addr, uint8_t reg)
+{	// writePointer
+	struct i2c_msg msg={addr,0,1,&reg};
+	return transfer(&msg,1);
+}	// writePointer
+
+bool TMP117LinuxTransport::readData(uint8_t addr, uint16_t & data)	// read register selected by pointer
+{	// readData
+	uint8_t buffer[2];
+	struct i2c_msg msg={addr,I2C_M_RD,2,buffer};
+	if (!transfer(&msg,1))
+		return false;
+	data=((uint16_t)buffer[0]<<8)|buffer[1];
+	return true;
+}	// readData
+
+bool TMP117LinuxTransport::readRegister(uint8_t addr, uint8_t reg, uint16_t & data)	// one combined message
+{	// readRegister
+	uint8_t buffer[2];
+	struct i2c_msg msg[2]={	{addr,0,1,&reg},
+							{addr,I2C_M_RD,2,buffer}};
+	if (!transfer(msg,2))
+		return false;
+	data=((uint16_t)buffer[0]<<8)|buffer[1];
+	return true;
+}	// readRegister
+
+bool TMP117LinuxTransport::writeRegister(uint8_t addr, uint8_t reg, uint16_t data)
+{	// writeRegister
+	uint8_t buffer[3]={reg,(uint8_t)(data>>8),(uint8_t)data};
+	struct i2c_msg msg={addr,0,3,buffer};
+	return transfer(&msg,1);
+}	// writeRegister
+
+uint8_t TMP117LinuxTransport::readMany(request_st * request, uint8_t count)	// returns number of successful reads
+{	// readMany
+	struct i2c_msg msg[2*MAX_REQUESTS];
+	uint8_t buffer[MAX_REQUESTS][2];
+	uint8_t done=0;
+	uint8_t n;
+	while (done<count)
+	{	// blocks of MAX_REQUESTS
+		uint8_t block=((count-done)>MAX_REQUESTS)?(MAX_REQUESTS):(count-done);
+		for (n=0; n<block; n++)
+		{	// combined message per request
+			request_st & r=request[done+n];
+			msg[2*n].addr=r.address;
+			msg[2*n].flags=0;
+			msg[2*n].len=1;
+			msg[2*n].buf=&r.reg;
+			msg[2*n+1].addr=r.address;
+			msg[2*n+1].flags=I2C_M_RD;
+			msg[2*n+1].len=2;
+			msg[2*n+1].buf=buffer[n];
+		}	// combined message per request
+		if (transfer(msg,2*block))
+			for (n=0; n<block; n++)
+			{	// all successful
+				request[done+n].data=((uint16_t)buffer[n][0]<<8)|buffer[n][1];
+				request[done+n].ok=true;
+			}	// all successful
+		else
+			// the adapter stops at the first failing message,
+			// retry one by one to find the missing sensor
+			for (n=0; n<block; n++)
+				request[done+n].ok=readRegister(request[done+n].address,
+												request[done+n].reg,
+												request[done+n].data);
+		done+=block;
+	}	// blocks of MAX_REQUESTS
+	for (n=0, done=0; n<count; n++)
+		if (request[n].ok)
+			done++;
+	return done;
+}	// readMany
+
+bool TMP117LinuxTransport::isStuck(void)				// false, the adapter driver handles timeouts
+{	// isStuck
+	return false;
+}	// isStuck
+
+bool TMP117LinuxTransport::recover(void)				// bus recovery is done by the adapter driver
+{	// recover
+	return fd>=0;
+}	// recover
+
+bool TMP117LinuxTransport::transfer(struct i2c_msg * msg, uint8_t count)	// one I2C_RDWR ioctl
+{	// transfer
+	struct i2c_rdwr_ioctl_data data={msg,count};
+	if (fd<0)
+		return false;
+	return ioctl(fd,I2C_RDWR,&data)==(int)count;
+}	// transfer
+
+#endif // __linux__
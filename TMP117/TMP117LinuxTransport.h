@@ -0,0 +1,53 @@
+#ifndef _TMP117_LINUX_TRANSPORT_
+#define _TMP117_LINUX_TRANSPORT_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* *********************************************************************
+ * Linux i2c-dev transport (/dev/i2c-N)
+ *
+ * every transfer is a single I2C_RDWR ioctl, a register read is one
+ * combined message (pointer write, repeated start, data read).
+ * readMany reads registers of several sensors with one system call.
+ * ********************************************************************* */
+
+struct i2c_msg;
+
+class TMP117LinuxTransport
+{
+	public:
+		static const uint8_t	MAX_REQUESTS	=21;		// I2C_RDWR_IOCTL_MAX_MSGS / 2
+		
+		typedef struct request_s {	uint8_t		address;
+									uint8_t		reg;
+									uint16_t	data;
+									bool		ok;
+								}	request_st;
+		
+		TMP117LinuxTransport(void);
+		~TMP117LinuxTransport(void);
+		
+		static TMP117LinuxTransport & getDefault(void);	// not opened
+		
+		bool open(const char * device);					// e.g. "/dev/i2c-1"
+		void close(void);
+		bool isOpen(void);
+		
+		bool probe(uint8_t addr);						// address acknowledged
+		bool writePointer(uint8_t addr, uint8_t reg);
+		bool readData(uint8_t addr, uint16_t & data);	// read register selected by pointer
+		bool readRegister(uint8_t addr, uint8_t reg, uint16_t & data);	// one combined message
+		bool writeRegister(uint8_t addr, uint8_t reg, uint16_t data);
+		
+		uint8_t readMany(request_st * request, uint8_t count);	// returns number of successful reads
+		bool isStuck(void);								// false, the adapter driver handles timeouts
+		bool recover(void);								// bus recovery is done by the adapter driver
+		
+	private:
+		int			fd;
+		
+		bool transfer(struct i2c_msg * msg, uint8_t count);	// one I2C_RDWR ioctl
+};
+
+#endif // _TMP117_LINUX_TRANSPORT_
@@ -0,0 +1,118 @@
+#ifndef _TMP117_MOCK_TRANSPORT_
+#define _TMP117_MOCK_TRANSPORT_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* *********************************************************************
+ * mock transport for tests without bus
+ *
+ * answers from a register file in RAM, no chip behaviour (flags,
+ * conversions, EEPROM) is emulated. A missing chip, failing transfers
+ * and a stuck bus can be injected, transfers and recoveries are counted.
+ * ********************************************************************* */
+
+class TMP117MockTransport
+{
+	public:
+		static const uint8_t	REGISTERS		=16;
+
+		TMP117MockTransport(void)
+		{	// constructor
+			for (uint8_t n=0; n<REGISTERS; n++)
+				reg[n]=0;
+			pointer=0;
+			present=true;
+			fail=0;
+			stuck=false;
+			transfers=0;
+			recoveries=0;
+		}	// constructor
+
+		static TMP117MockTransport & getDefault(void)
+		{	// getDefault
+			static TMP117MockTransport transport;
+			return transport;
+		}	// getDefault
+
+		void setRegister(uint8_t n, uint16_t val)	{	reg[n%REGISTERS]=val;	}
+		uint16_t getRegister(uint8_t n)				{	return reg[n%REGISTERS];	}
+		void setPresent(bool present)				{	this->present=present;	}	// chip acknowledges address
+		void failNext(uint8_t count)				{	fail=count;	}				// next transfers fail
+		void setStuck(bool stuck)					{	this->stuck=stuck;	}		// transfers fail until recover()
+		uint32_t getTransfers(void)					{	return transfers;	}
+		uint32_t getRecoveries(void)				{	return recoveries;	}
+
+		inline bool probe(uint8_t addr)
+		{	// probe
+			(void)addr;
+			return transfer();
+		}	// probe
+
+		inline bool writePointer(uint8_t addr, uint8_t reg)
+		{	// writePointer
+			(void)addr;
+			if (!transfer())
+				return false;
+			pointer=reg%REGISTERS;
+			return true;
+		}	// writePointer
+
+		inline bool readData(uint8_t addr, uint16_t & data)
+		{	// readData
+			(void)addr;
+			if (!transfer())
+				return false;
+			data=reg[pointer];
+			return true;
+		}	// readData
+
+		inline bool readRegister(uint8_t addr, uint8_t reg, uint16_t & data)
+		{	// readRegister
+			return writePointer(addr,reg) && readData(addr,data);
+		}	// readRegister
+
+		inline bool writeRegister(uint8_t addr, uint8_t reg, uint16_t data)
+		{	// writeRegister
+			if (!writePointer(addr,reg))
+				return false;
+			this->reg[pointer]=data;
+			return true;
+		}	// writeRegister
+
+		inline bool isStuck(void)
+		{	// isStuck
+			return stuck;
+		}	// isStuck
+
+		inline bool recover(void)
+		{	// recover
+			recoveries++;
+			stuck=false;
+			return present;
+		}	// recover
+
+	private:
+		uint16_t	reg[REGISTERS];
+		uint8_t		pointer;
+		bool		present;
+		uint8_t		fail;
+		bool		stuck;
+		uint32_t	transfers;
+		uint32_t	recoveries;
+
+		bool transfer(void)
+		{	// transfer
+			transfers++;
+			if (stuck)
+				return false;
+			if (fail)
+			{	// injected failure
+				fail--;
+				return false;
+			}	// injected failure
+			return present;
+		}	// transfer
+};
+
+#endif // _TMP117_MOCK_TRANSPORT_
@@ -0,0 +1,62 @@
+#ifndef _TMP117_PROFILE_
+#define _TMP117_PROFILE_
+
+#include <stdint.h>
+#include "TMP117.h"
+
+/* *********************************************************************
+ * compile time configuration profile
+ *
+ * configuration word, limit and offset registers are computed by the 
+ * compiler, invalid combinations fail to compile. Limits and offset are
+ * given in 1/100°C. TMP117::init(profile) writes each register once,
+ * TMP117::init(profile,changes) only registers that differ. Without
+ * OFFSET the offset of the chip (calibration) is kept.
+ *
+ * typedef TMP117Profile<	TMP117::MODE_CONTINUOUS,
+ *							TMP117::AVERAGING_32,
+ *							TMP117::CONVERSION_TIME_1s,
+ *							3000, 1000>	Room;
+ * sensor.init(Room::profile());
+ * ********************************************************************* */
+
+class TMP117ProfileBase
+{
+	public:
+		static const int32_t	LIMIT_MIN		=-25600;	// 1/100°C, IQ9.7 0x8000
+		static const int32_t	LIMIT_MAX		=25599;		// 1/100°C, IQ9.7 0x7FFF
+		static const int32_t	OFFSET_KEEP		=INT32_MIN;	// offset register is not written
+
+};
+
+template<	TMP117::conversion_mode_et		MODE		=TMP117::MODE_CONTINUOUS,
+			TMP117::averaging_mode_et		AVERAGING	=TMP117::AVERAGING_8,
+			TMP117::conversion_time_et		TIME		=TMP117::CONVERSION_TIME_1s,
+			int32_t							HIGH_LIMIT	=19200,			// 1/100°C
+			int32_t							LOW_LIMIT	=-25600,		// 1/100°C
+			TMP117::alert_mode_select_et	ALERT_MODE	=TMP117::ALERT_MODE_ALERT,
+			TMP117::alert_pin_polarity_et	POLARITY	=TMP117::ALERT_PIN_ACTIVE_LOW,
+			TMP117::alert_pin_select_et		PIN_SOURCE	=TMP117::ALERT_PIN_ALERT,
+			int32_t							OFFSET		=TMP117ProfileBase::OFFSET_KEEP>	// 1/100°C
+class TMP117Profile : public TMP117ProfileBase
+{
+	public:
+		static_assert(MODE!=TMP117::MODE_CONTINUOUS_RES,"reserved conversion mode");
+		static_assert((HIGH_LIMIT>=LIMIT_MIN) && (HIGH_LIMIT<=LIMIT_MAX),"high limit outside IQ9.7 range");
+		static_assert((LOW_LIMIT>=LIMIT_MIN) && (LOW_LIMIT<=LIMIT_MAX),"low limit outside IQ9.7 range");
+		static_assert(LOW_LIMIT<HIGH_LIMIT,"low limit not below high limit");
+		static_assert((OFFSET==OFFSET_KEEP) || ((OFFSET>=LIMIT_MIN) && (OFFSET<=LIMIT_MAX)),"offset outside IQ9.7 range");
+
+		static const uint16_t	CONFIG			=TMP117::encodeConfig(MODE,AVERAGING,TIME,ALERT_MODE,POLARITY,PIN_SOURCE);
+		static const int16_t	HIGH_LIMIT_IQ	=TMP117Convert::toIQ<2>(HIGH_LIMIT);	// IQ9.7
+		static const int16_t	LOW_LIMIT_IQ	=TMP117Convert::toIQ<2>(LOW_LIMIT);		// IQ9.7
+		static const bool		WRITE_OFFSET	=OFFSET!=OFFSET_KEEP;
+		static const int16_t	OFFSET_IQ		=(WRITE_OFFSET)?(TMP117Convert::toIQ<2>(OFFSET)):(0);	// IQ9.7
+
+		static constexpr TMP117::profile_st profile(void)
+		{	// profile
+			return {CONFIG,HIGH_LIMIT_IQ,LOW_LIMIT_IQ,OFFSET_IQ,WRITE_OFFSET};
+		}	// profile
+};
+
+#endif // _TMP117_PROFILE_
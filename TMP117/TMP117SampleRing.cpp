@@ -0,0 +1,54 @@
+#include "TMP117SampleRing.h"
+
+TMP117SampleRing::TMP117SampleRing(void)
+{	// constructor
+	buffer=NULL;
+	mask=0;
+	head=0;
+	tail=0;
+}	// constructor
+
+bool TMP117SampleRing::begin(TMP117::sample_st * storage, uint8_t size)	// size power of two, max. 128
+{	// begin
+	bool valid=(storage!=NULL) && (size>0) && (size<=128) && !(size&(size-1));
+	buffer=(valid)?(storage):(NULL);
+	mask=(valid)?(size-1):(0);
+	head=0;
+	tail=0;
+	return valid;
+}	// begin
+
+bool TMP117SampleRing::push(const TMP117::sample_st & sample)			// producer, false if full
+{	// push
+	uint8_t h=head;
+	if (!buffer || ((uint8_t)(h-tail)>mask))
+		return false;
+	buffer[h&mask]=sample;
+	__sync_synchronize();			// sample visible before index
+	head=h+1;
+	return true;
+}	// push
+
+bool TMP117SampleRing::pop(TMP117::sample_st & sample)					// consumer, false if empty
+{	// pop
+	uint8_t t=tail;
+	if (t==head)
+		return false;
+	sample=buffer[t&mask];
+	__sync_synchronize();			// sample copied before slot is released
+	tail=t+1;
+	return true;
+}	// pop
+
+uint8_t TMP117SampleRing::read(TMP117::sample_st * samples, uint8_t max)	// consumer, drains up to max samples
+{	// read
+	uint8_t n=0;
+	while ((n<max) && pop(samples[n]))
+		n++;
+	return n;
+}	// read
+
+uint8_t TMP117SampleRing::available(void)								// samples waiting
+{	// available
+	return (uint8_t)(head-tail);
+}	// available
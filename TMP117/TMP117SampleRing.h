@@ -0,0 +1,35 @@
+#ifndef _TMP117_SAMPLE_RING_
+#define _TMP117_SAMPLE_RING_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "TMP117.h"
+
+/* *********************************************************************
+ * lock free single producer / single consumer ring buffer of samples
+ *
+ * the storage is provided by the application, its size needs to be a 
+ * power of two (max. 128). Indices are free running 8 bit values, each
+ * one is written by one side only.
+ * ********************************************************************* */
+
+class TMP117SampleRing
+{
+	public:
+		TMP117SampleRing(void);
+		
+		bool begin(TMP117::sample_st * storage, uint8_t size);	// size power of two, max. 128
+		
+		bool push(const TMP117::sample_st & sample);			// producer, false if full
+		bool pop(TMP117::sample_st & sample);					// consumer, false if empty
+		uint8_t read(TMP117::sample_st * samples, uint8_t max);	// consumer, drains up to max samples
+		uint8_t available(void);								// samples waiting
+		
+	private:
+		TMP117::sample_st *	buffer;
+		uint8_t				mask;
+		volatile uint8_t	head;			// written by producer only
+		volatile uint8_t	tail;			// written by consumer only
+};
+
+#endif // _TMP117_SAMPLE_RING_
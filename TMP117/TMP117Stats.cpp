@@ -0,0 +1,146 @@
+#include "TMP117Stats.h"
+
+TMP117Stats::TMP117Stats(void)
+{	// constructor
+	window=NULL;
+	window_size=0;
+	alpha=32;
+	reset();
+}	// constructor
+
+void TMP117Stats::begin(int16_t * window, uint8_t windowSize, uint8_t alpha)	// alpha in 1/256
+{	// begin
+	this->window=(windowSize)?(window):(NULL);
+	window_size=(window)?(windowSize):(0);
+	setAlpha(alpha);
+	reset();
+}	// begin
+
+void TMP117Stats::reset(void)						// restart statistics, keeps configuration
+{	// reset
+	count=0;
+	min=INT16_MAX;
+	max=INT16_MIN;
+	mean=0;
+	m2=0;
+	ema=0;
+	window_index=0;
+	window_fill=0;
+	window_sum=0;
+}	// reset
+
+void TMP117Stats::setAlpha(uint8_t alpha)			// EMA weight of new sample in 1/256, 0=256
+{	// setAlpha
+	this->alpha=(alpha)?(alpha):(256);
+}	// setAlpha
+
+void TMP117Stats::update(int16_t temp)				// add IQ9.7 sample
+{	// update
+	int32_t val=(int32_t)temp<<FRACTION;
+	int32_t delta;
+	
+	count++;
+	if (temp<min) min=temp;
+	if (temp>max) max=temp;
+	
+	// Welford
+	delta=val-mean;
+	// rounded division, truncation would bias the mean towards the first samples
+	mean+=(delta+((delta<0)?(-(int32_t)(count>>1)):((int32_t)(count>>1))))/(int32_t)count;
+	// not negative, both factors have the sign of delta, FRACTION bits are kept
+	// as small deviations would be truncated to 0 in every single step
+	m2+=(uint64_t)((int64_t)delta*(val-mean))>>FRACTION;
+	
+	// exponential moving average
+	if (count==1)
+		ema=val;
+	else
+		ema+=(int32_t)(((int64_t)(val-ema)*alpha)>>8);
+	
+	// moving average
+	if (window_size)
+	{	// window
+		if (window_fill<window_size)
+			window_fill++;
+		else
+			window_sum-=window[window_index];
+		window[window_index]=temp;
+		window_sum+=temp;
+		if (++window_index>=window_size)
+			window_index=0;
+	}	// window
+}	// update
+
+uint32_t TMP117Stats::getCount(void)
+{	// getCount
+	return count;
+}	// getCount
+
+int16_t TMP117Stats::getMin(void)					// IQ9.7
+{	// getMin
+	return min;
+}	// getMin
+
+int16_t TMP117Stats::getMax(void)					// IQ9.7
+{	// getMax
+	return max;
+}	// getMax
+
+int16_t TMP117Stats::getMean(void)					// IQ9.7
+{	// getMean
+	return round(mean);
+}	// getMean
+
+uint32_t TMP117Stats::getVariance(void)				// sample variance in (1/128°C)^2
+{	// getVariance
+	return (count>1)?((uint32_t)((m2/(count-1)+(1UL<<(FRACTION-1)))>>FRACTION)):(0);
+}	// getVariance
+
+int16_t TMP117Stats::getStdDev(void)				// IQ9.7
+{	// getStdDev
+	return isqrt(getVariance());
+}	// getStdDev
+
+int16_t TMP117Stats::getEma(void)					// IQ9.7
+{	// getEma
+	return round(ema);
+}	// getEma
+
+int16_t TMP117Stats::getMovingAverage(void)			// IQ9.7, average of window
+{	// getMovingAverage
+	int32_t half;
+	if (!window_fill)
+		return 0;
+	half=(window_sum<0)?(-(int32_t)window_fill/2):(window_fill/2);
+	return (window_sum+half)/window_fill;
+}	// getMovingAverage
+
+/* *********************************************************************
+ * private functions
+ * ********************************************************************* */
+
+int16_t TMP117Stats::round(int32_t val)				// remove additional fractional bits
+{	// round
+	// half away from zero like the moving average
+	return (val<0)?(-((-val+(1L<<(FRACTION-1)))>>FRACTION)):((val+(1L<<(FRACTION-1)))>>FRACTION);
+}	// round
+
+uint16_t TMP117Stats::isqrt(uint32_t val)
+{	// isqrt
+	uint32_t result=0;
+	uint32_t bit=1UL<<30;
+	while (bit>val)
+		bit>>=2;
+	while (bit)
+	{	// digit by digit
+		if (val>=result+bit)
+		{	// set bit
+			val-=result+bit;
+			result=(result>>1)+bit;
+		}	// set bit
+		else
+			result>>=1;
+		bit>>=2;
+	}	// digit by digit
+	return result;
+}	// isqrt
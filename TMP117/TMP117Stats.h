@@ -0,0 +1,59 @@
+#ifndef _TMP117_STATS_
+#define _TMP117_STATS_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* *********************************************************************
+ * online statistics of IQ9.7 samples in fixed point
+ *
+ * min, max, mean and variance (Welford), exponential moving average
+ * and a windowed moving average. Mean, EMA and variance are kept with
+ * 12 additional fractional bits. The window storage is provided by the
+ * application.
+ * ********************************************************************* */
+
+class TMP117Stats
+{
+	public:
+		TMP117Stats(void);
+		
+		void begin(int16_t * window=NULL, uint8_t windowSize=0, uint8_t alpha=32);	// alpha in 1/256
+		void reset(void);							// restart statistics, keeps configuration
+		void setAlpha(uint8_t alpha);				// EMA weight of new sample in 1/256, 0=256
+		
+		void update(int16_t temp);					// add IQ9.7 sample
+		
+		uint32_t getCount(void);
+		int16_t getMin(void);						// IQ9.7
+		int16_t getMax(void);						// IQ9.7
+		int16_t getMean(void);						// IQ9.7
+		uint32_t getVariance(void);					// sample variance in (1/128°C)^2
+		int16_t getStdDev(void);					// IQ9.7
+		int16_t getEma(void);						// IQ9.7
+		int16_t getMovingAverage(void);				// IQ9.7, average of window
+		
+	private:
+	
+		static const uint8_t	FRACTION	=12;	// additional fractional bits
+	
+		uint32_t	count;
+		int16_t		min;
+		int16_t		max;
+		int32_t		mean;						// IQ9.7 << FRACTION
+		uint64_t	m2;							// sum of squared deviations in (1/128°C)^2 << FRACTION
+		int32_t		ema;						// IQ9.7 << FRACTION
+		uint16_t	alpha;
+		
+		int16_t *	window;
+		uint8_t		window_size;
+		uint8_t		window_index;
+		uint8_t		window_fill;
+		int32_t		window_sum;
+		
+		static int16_t round(int32_t val);		// remove additional fractional bits
+		static uint16_t isqrt(uint32_t val);
+};
+
+#endif // _TMP117_STATS_
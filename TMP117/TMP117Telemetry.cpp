@@ -0,0 +1,185 @@
+#include <Arduino.h>
+#include "TMP117Telemetry.h"
+
+TMP117Telemetry::TMP117Telemetry(void)
+{	// constructor
+	out=NULL;
+	channel=NULL;
+	channels=0;
+	max_age=0;
+	write_chunk=WRITE_CHUNK;
+	next=0;
+	frame_length=0;
+	frame_pos=0;
+	frames=0;
+	dropped=0;
+}	// constructor
+
+void TMP117Telemetry::begin(Print & out, channel_st * storage, uint8_t channels, uint16_t maxAge, uint8_t writeChunk)
+{	// begin
+	this->out=&out;
+	channel=storage;
+	this->channels=channels;
+	max_age=maxAge;
+	write_chunk=writeChunk;
+	next=0;
+	frame_length=0;
+	frame_pos=0;
+	frames=0;
+	dropped=0;
+	for (uint8_t n=0; n<channels; n++)
+	{	// init channels
+		channel[n].id=n;
+		channel[n].fill=0;
+		for (uint8_t b=0; b<2; b++)
+		{	// buffers
+			channel[n].buffer[b].count=0;
+			channel[n].buffer[b].ready=false;
+		}	// buffers
+	}	// init channels
+}	// begin
+
+void TMP117Telemetry::setId(uint8_t channel, uint8_t id)	// id in frame, default channel index
+{	// setId
+	if (channel<channels)
+		this->channel[channel].id=id;
+}	// setId
+
+bool TMP117Telemetry::add(uint8_t channel, int16_t temp, uint32_t timestamp)	// false if sample dropped
+{	// add
+	buffer_st * buf;
+	if (channel>=channels)
+		return false;
+	buf=&this->channel[channel].buffer[this->channel[channel].fill];
+	if (buf->ready)
+	{	// both buffers wait for output
+		dropped++;
+		return false;
+	}	// both buffers wait for output
+	if (!buf->count)
+		buf->timestamp=timestamp;
+	buf->last=timestamp;
+	buf->temp[buf->count++]=temp;
+	if (buf->count>=SAMPLES)
+		complete(this->channel[channel]);
+	return true;
+}	// add
+
+bool TMP117Telemetry::add(uint8_t channel, const TMP117::sample_st & sample)
+{	// add(sample)
+	return add(channel,sample.temp,sample.timestamp);
+}	// add(sample)
+
+void TMP117Telemetry::flush(uint8_t channel)		// send partial frame
+{	// flush
+	if (channel<channels)
+	{	// valid channel
+		buffer_st & buf=this->channel[channel].buffer[this->channel[channel].fill];
+		if (buf.count && !buf.ready)
+			complete(this->channel[channel]);
+	}	// valid channel
+}	// flush
+
+bool TMP117Telemetry::process_idle(void)			// frame and write, true if idle
+{	// process_idle
+	if (max_age)
+	{	// send partial frames after max_age
+		uint32_t now=millis();
+		for (uint8_t n=0; n<channels; n++)
+		{	// check age
+			buffer_st & buf=channel[n].buffer[channel[n].fill];
+			if (buf.count && !buf.ready && ((now-buf.timestamp)>=max_age))
+				complete(channel[n]);
+		}	// check age
+	}	// send partial frames after max_age
+	if ((frame_pos>=frame_length) && !build_frame())
+		return true;
+	{	// write frame
+		int space=out->availableForWrite();
+		uint16_t length=frame_length-frame_pos;
+		if (space<=0)
+			// no space or not reported by the output, blocking write of a chunk
+			space=write_chunk;
+		if (!space)
+			return false;
+		if (length>(uint16_t)space)
+			length=space;
+		frame_pos+=out->write(&frame[frame_pos],length);
+		if (frame_pos>=frame_length)
+			frames++;
+	}	// write frame
+	return false;
+}	// process_idle
+
+uint32_t TMP117Telemetry::getFrames(void)			// frames written completely
+{	// getFrames
+	return frames;
+}	// getFrames
+
+uint32_t TMP117Telemetry::getDropped(void)			// samples lost, both buffers waiting
+{	// getDropped
+	return dropped;
+}	// getDropped
+
+uint16_t TMP117Telemetry::crc16(const uint8_t * data, uint16_t length, uint16_t crc)
+{	// crc16, CCITT polynomial 0x1021, bitwise without table
+	while (length--)
+	{	// bytes
+		crc^=(uint16_t)(*data++)<<8;
+		for (uint8_t bit=0; bit<8; bit++)
+			crc=(crc&0x8000)?((crc<<1)^0x1021):(crc<<1);
+	}	// bytes
+	return crc;
+}	// crc16
+
+/* *********************************************************************
+ * private functions
+ * ********************************************************************* */
+
+bool TMP117Telemetry::build_frame(void)				// frame next ready buffer, release buffer
+{	// build_frame
+	for (uint8_t n=0; n<channels; n++)
+	{	// round robin over channels
+		channel_st & ch=channel[(next+n)%channels];
+		// fill buffer is only ready if both are, then it is the older one
+		buffer_st & buf=(ch.buffer[ch.fill].ready)?(ch.buffer[ch.fill]):(ch.buffer[ch.fill^1]);
+		if (buf.ready)
+		{	// frame buffer
+			uint16_t interval=(buf.count>1)?((buf.last-buf.timestamp)/(buf.count-1)):(0);
+			uint16_t pos=HEADER_SIZE;
+			uint16_t crc;
+			frame[0]=SYNC_0;
+			frame[1]=SYNC_1;
+			frame[2]=ch.id;
+			frame[3]=buf.count;
+			frame[4]=buf.timestamp&0xFF;
+			frame[5]=(buf.timestamp>>8)&0xFF;
+			frame[6]=(buf.timestamp>>16)&0xFF;
+			frame[7]=(buf.timestamp>>24)&0xFF;
+			frame[8]=interval&0xFF;
+			frame[9]=(interval>>8)&0xFF;
+			for (uint8_t s=0; s<buf.count; s++)
+			{	// samples
+				frame[pos++]=(uint16_t)buf.temp[s]&0xFF;
+				frame[pos++]=((uint16_t)buf.temp[s]>>8)&0xFF;
+			}	// samples
+			crc=crc16(&frame[2],pos-2);
+			frame[pos++]=crc&0xFF;
+			frame[pos++]=(crc>>8)&0xFF;
+			frame_length=pos;
+			frame_pos=0;
+			// buffer is free again
+			buf.count=0;
+			buf.ready=false;
+			next=((next+n)%channels+1)%channels;
+			return true;
+		}	// frame buffer
+	}	// round robin over channels
+	return false;
+}	// build_frame
+
+void TMP117Telemetry::complete(channel_st & ch)		// mark fill buffer ready, switch buffers
+{	// complete
+	ch.buffer[ch.fill].ready=true;
+	ch.fill^=1;
+}	// complete
@@ -0,0 +1,95 @@
+#ifndef _TMP117_TELEMETRY_
+#define _TMP117_TELEMETRY_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <Arduino.h>
+#include "TMP117.h"
+
+#ifndef TMP117_TELEMETRY_SAMPLES
+#define TMP117_TELEMETRY_SAMPLES	16		// samples per frame
+#endif
+
+/* *********************************************************************
+ * batched binary telemetry frames
+ *
+ * samples of each channel (sensor) are collected in two buffers, a full
+ * buffer is framed and written by the task function as far as the 
+ * output accepts data without blocking (availableForWrite()) while the
+ * other buffer is filled. If the output reports no space (the Print
+ * default always returns 0) a bounded blocking write of writeChunk
+ * bytes per call is done instead. Frames of different channels never
+ * interleave.
+ *
+ * frame, multi byte values little endian
+ *  0..1	sync 0xA5 0x17
+ *  2		channel id
+ *  3		number of samples N
+ *  4..7	timestamp of first sample, ms
+ *  8..9	mean sample interval, ms
+ *  10..	N samples IQ9.7
+ *  end		CRC16-CCITT (0x1021, init 0xFFFF) of id ... last sample
+ * ********************************************************************* */
+
+class TMP117Telemetry
+{
+	public:
+		static const uint8_t	SAMPLES			=TMP117_TELEMETRY_SAMPLES;
+		static const uint8_t	SYNC_0			=0xA5;
+		static const uint8_t	SYNC_1			=0x17;
+		static const uint8_t	HEADER_SIZE		=10;
+		static const uint8_t	CRC_SIZE		=2;
+		static const uint16_t	FRAME_SIZE		=HEADER_SIZE+2*SAMPLES+CRC_SIZE;
+		static const uint16_t	CRC_INIT		=0xFFFF;
+		static const uint8_t	WRITE_CHUNK		=8;		// bytes per call if availableForWrite() is 0
+		
+		typedef struct buffer_s {	uint32_t	timestamp;			// ms, first sample
+									uint32_t	last;				// ms, last sample
+									int16_t		temp[SAMPLES];		// IQ9.7
+									uint8_t		count;
+									bool		ready;				// waiting for output
+								}	buffer_st;
+		
+		typedef struct channel_s {	buffer_st	buffer[2];
+									uint8_t		id;
+									uint8_t		fill;				// buffer being filled
+								}	channel_st;
+		
+		TMP117Telemetry(void);
+		
+		void begin(	Print & out, channel_st * storage, uint8_t channels, 	// storage provided by application
+					uint16_t maxAge=0,										// ms, send partial frames, 0: never
+					uint8_t writeChunk=WRITE_CHUNK);						// blocking write if no space reported, 0: wait for space
+		void setId(uint8_t channel, uint8_t id);		// id in frame, default channel index
+		
+		bool add(uint8_t channel, int16_t temp, uint32_t timestamp);	// false if sample dropped
+		bool add(uint8_t channel, const TMP117::sample_st & sample);
+		void flush(uint8_t channel);					// send partial frame
+		
+		bool process_idle(void);						// frame and write, true if idle
+		
+		uint32_t getFrames(void);						// frames written completely
+		uint32_t getDropped(void);						// samples lost, both buffers waiting
+		
+		static uint16_t crc16(const uint8_t * data, uint16_t length, uint16_t crc=CRC_INIT);
+		
+	private:
+		Print *			out;
+		channel_st *	channel;
+		uint8_t			channels;
+		uint16_t		max_age;
+		uint8_t			write_chunk;				// blocking write if availableForWrite() is 0
+		uint8_t			next;						// next channel to be framed, round robin
+		
+		uint8_t			frame[FRAME_SIZE];			// frame being written
+		uint16_t		frame_length;
+		uint16_t		frame_pos;
+		
+		uint32_t		frames;
+		uint32_t		dropped;
+		
+		bool build_frame(void);						// frame next ready buffer, release buffer
+		void complete(channel_st & ch);				// mark fill buffer ready, switch buffers
+};
+
+#endif // _TMP117_TELEMETRY_
@@ -0,0 +1,89 @@
+#include "TMP117Trace.h"
+
+TMP117Trace::TMP117Trace(uint8_t * buffer, uint16_t size)	// record into RAM
+{	// constructor(buffer)
+	this->buffer=buffer;
+	this->size=size;
+	sink=NULL;
+	context=NULL;
+	clear();
+}	// constructor(buffer)
+
+TMP117Trace::TMP117Trace(sink_cb_t sink, void * context)	// pass each record to sink
+{	// constructor(sink)
+	buffer=NULL;
+	size=0;
+	this->sink=sink;
+	this->context=context;
+	clear();
+}	// constructor(sink)
+
+void TMP117Trace::record(uint32_t timestamp, uint8_t address, uint8_t reg, op_et op, bool ok, uint16_t data)
+{	// record
+	record_st rec={timestamp,address,reg,op,ok,data};
+	records++;
+	if (sink)
+	{	// streaming
+		uint8_t raw[RECORD_SIZE];
+		encode(rec,raw);
+		sink(raw,RECORD_SIZE,context);
+	}	// streaming
+	else if (buffer && (size-length>=RECORD_SIZE))
+	{	// append
+		encode(rec,&buffer[length]);
+		length+=RECORD_SIZE;
+	}	// append
+	else
+		lost++;
+}	// record
+
+void TMP117Trace::clear(void)
+{	// clear
+	length=0;
+	records=0;
+	lost=0;
+}	// clear
+
+const uint8_t * TMP117Trace::getBuffer(void)
+{	// getBuffer
+	return buffer;
+}	// getBuffer
+
+uint16_t TMP117Trace::getLength(void)						// bytes in buffer
+{	// getLength
+	return length;
+}	// getLength
+
+uint32_t TMP117Trace::getRecords(void)						// records since clear
+{	// getRecords
+	return records;
+}	// getRecords
+
+uint32_t TMP117Trace::getLost(void)							// records not stored, buffer full
+{	// getLost
+	return lost;
+}	// getLost
+
+void TMP117Trace::encode(const record_st & rec, uint8_t * data)	// RECORD_SIZE bytes
+{	// encode
+	data[0]=rec.timestamp&0xFF;
+	data[1]=(rec.timestamp>>8)&0xFF;
+	data[2]=(rec.timestamp>>16)&0xFF;
+	data[3]=(rec.timestamp>>24)&0xFF;
+	data[4]=rec.address;
+	data[5]=rec.reg;
+	data[6]=(rec.op&FLAG_OP_MASK)|((rec.ok)?(FLAG_OK):(0));
+	data[7]=rec.data&0xFF;
+	data[8]=(rec.data>>8)&0xFF;
+}	// encode
+
+void TMP117Trace::decode(const uint8_t * data, record_st & rec)
+{	// decode
+	rec.timestamp=	(uint32_t)data[0] | ((uint32_t)data[1]<<8) |
+					((uint32_t)data[2]<<16) | ((uint32_t)data[3]<<24);
+	rec.address=data[4];
+	rec.reg=data[5];
+	rec.op=(op_et)(data[6]&FLAG_OP_MASK);
+	rec.ok=(data[6]&FLAG_OK)!=0;
+	rec.data=(uint16_t)data[7] | ((uint16_t)data[8]<<8);
+}	// decode
@@ -0,0 +1,72 @@
+#ifndef _TMP117_TRACE_
+#define _TMP117_TRACE_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* *********************************************************************
+ * binary trace of the bus operations of a TMP117
+ *
+ * every attempt of a bus operation is recorded with timestamp, address,
+ * register, operation, result and data. Records are either appended to
+ * a buffer provided by the application (recording stops when full) or
+ * handed to a sink callback, e.g. to write them to a serial port.
+ *
+ * record, RECORD_SIZE bytes, multi byte values little endian
+ *  0..3	timestamp, micros() at start of attempt
+ *  4		I2C address
+ *  5		register (POINTER_UNKNOWN for probe and unknown pointer)
+ *  6		flags, bit 0..2 operation, bit 7 success
+ *  7..8	data written or read
+ * ********************************************************************* */
+
+class TMP117Trace
+{
+	public:
+		static const uint8_t	RECORD_SIZE		=9;
+		static const uint8_t	FLAG_OP_MASK	=0x07;
+		static const uint8_t	FLAG_OK			=0x80;
+		
+		typedef enum:uint8_t {	OP_POINTER,			// write pointer register
+								OP_READ_DATA,		// read register selected by pointer
+								OP_READ,			// pointer and data with repeated start
+								OP_WRITE,			// pointer and data
+								OP_PROBE			// address only
+								} op_et;
+		
+		typedef struct record_s {	uint32_t	timestamp;		// µs
+									uint8_t		address;
+									uint8_t		reg;
+									op_et		op;
+									bool		ok;
+									uint16_t	data;
+								}	record_st;
+		
+		typedef void (*sink_cb_t)(const uint8_t * record, uint8_t len, void * context);
+		
+		TMP117Trace(uint8_t * buffer, uint16_t size);				// record into RAM
+		TMP117Trace(sink_cb_t sink, void * context=NULL);			// pass each record to sink
+		
+		void record(uint32_t timestamp, uint8_t address, uint8_t reg, op_et op, bool ok, uint16_t data);
+		void clear(void);
+		
+		const uint8_t * getBuffer(void);
+		uint16_t getLength(void);						// bytes in buffer
+		uint32_t getRecords(void);						// records since clear
+		uint32_t getLost(void);							// records not stored, buffer full
+		
+		static void encode(const record_st & rec, uint8_t * data);	// RECORD_SIZE bytes
+		static void decode(const uint8_t * data, record_st & rec);
+		
+	private:
+		uint8_t *	buffer;
+		uint16_t	size;
+		uint16_t	length;
+		sink_cb_t	sink;
+		void *		context;
+		uint32_t	records;
+		uint32_t	lost;
+};
+
+#endif // _TMP117_TRACE_
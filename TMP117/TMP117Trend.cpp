@@ -0,0 +1,158 @@
+#include <Arduino.h>
+#include "TMP117Trend.h"
+
+const TMP117Trend::config_st TMP117Trend::DEFAULT_CONFIG={
+	128,				// 0.5
+	32,					// 0.125
+	10000,
+	6					// 0.05°C/s
+};
+
+TMP117Trend::TMP117Trend(TMP117 & sensor) : sensor(sensor)
+{	// constructor
+	config=DEFAULT_CONFIG;
+	callback=NULL;
+	context=NULL;
+	reset();
+}	// constructor
+
+void TMP117Trend::begin(warning_cb_t callback, void * context, const config_st & config)
+{	// begin
+	this->callback=callback;
+	this->context=context;
+	this->config=config;
+	reset();
+}	// begin
+
+void TMP117Trend::reset(void)						// restart estimation
+{	// reset
+	level=0;
+	trend=0;
+	last_sample=0;
+	samples=0;
+	crossing=NO_CROSSING;
+	direction=WARNING_NONE;
+	warning=WARNING_NONE;
+}	// reset
+
+bool TMP117Trend::process_idle(void)
+{	// process_idle
+	bool idle=true;
+	uint32_t now=millis();
+	// poll status only when a new result is expected
+	if (((now-last_sample)>=sensor.getConversionCycleTime()) && sensor.isDataReady())
+	{	// new result
+		int16_t temp=sensor.getTemp();
+		if (sensor.isBusOk())
+			update(temp,now);
+		idle=false;
+	}	// new result
+	return idle;
+}	// process_idle
+
+void TMP117Trend::update(int16_t temp, uint32_t timestamp)	// feed sample read elsewhere (IQ9.7, ms)
+{	// update
+	static const int32_t VALUE_MAX=(int32_t)INT16_MAX<<FRACTION_BITS;
+	int32_t value=(int32_t)temp<<FRACTION_BITS;
+	uint32_t dt=timestamp-last_sample;
+	if (!samples || (dt>MAX_GAP))
+	{	// (re)start with level only
+		level=value;
+		trend=0;
+		samples=0;
+	}	// (re)start with level only
+	else if (dt)
+	{	// Holt, level and trend
+		int32_t previous=level;
+		int32_t rate;
+		int32_t predicted=level+(int32_t)((int64_t)trend*dt/1000);
+		predicted=(predicted>VALUE_MAX)?(VALUE_MAX):((predicted<-VALUE_MAX)?(-VALUE_MAX):(predicted));
+		level=predicted+(((value-predicted)*config.alpha)>>8);
+		rate=(int32_t)((int64_t)(level-previous)*1000/(int32_t)dt);
+		rate=(rate>VALUE_MAX)?(VALUE_MAX):((rate<-VALUE_MAX)?(-VALUE_MAX):(rate));
+		trend+=((rate-trend)*config.beta)>>8;
+	}	// Holt, level and trend
+	last_sample=timestamp;
+	samples++;
+	forecast();
+}	// update
+
+int16_t TMP117Trend::getLevel(void)					// smoothed temperature in IQ9.7
+{	// getLevel
+	return level>>FRACTION_BITS;
+}	// getLevel
+
+int16_t TMP117Trend::getTrend(void)					// IQ9.7 per second
+{	// getTrend
+	return trend>>FRACTION_BITS;
+}	// getTrend
+
+int16_t TMP117Trend::getForecast(uint32_t ms)		// IQ9.7, ms after last sample
+{	// getForecast
+	int64_t value=((int64_t)level+(int64_t)trend*ms/1000)>>FRACTION_BITS;
+	return (value>INT16_MAX)?(INT16_MAX):((value<INT16_MIN)?(INT16_MIN):((int16_t)value));
+}	// getForecast
+
+uint32_t TMP117Trend::predictedCrossingMs(void)		// ms from now until a limit is crossed, 
+													// 0 if beyond, NO_CROSSING if not forecast
+{	// predictedCrossingMs
+	uint32_t elapsed=millis()-last_sample;
+	if (crossing==NO_CROSSING)
+		return NO_CROSSING;
+	return (crossing>elapsed)?(crossing-elapsed):(0);
+}	// predictedCrossingMs
+
+TMP117Trend::warning_et TMP117Trend::getWarning(void)
+{	// getWarning
+	return warning;
+}	// getWarning
+
+uint32_t TMP117Trend::getSamples(void)
+{	// getSamples
+	return samples;
+}	// getSamples
+
+/* *********************************************************************
+ * private functions
+ * ********************************************************************* */
+
+void TMP117Trend::forecast(void)					// crossing and warning from level and trend
+{	// forecast
+	// limits from shadow registers, no bus access
+	int32_t high=(int32_t)sensor.getHighTemperaturLimit()<<FRACTION_BITS;
+	int32_t low=(int32_t)sensor.getLowTemperaturLimit()<<FRACTION_BITS;
+	int32_t min_rate=(int32_t)config.minRate<<FRACTION_BITS;
+	warning_et state=WARNING_NONE;
+	crossing=NO_CROSSING;
+	direction=WARNING_NONE;
+	if (samples<MIN_SAMPLES)
+		return;
+	if (level>=high)
+	{	// beyond high limit
+		crossing=0;
+		direction=WARNING_HIGH;
+	}	// beyond high limit
+	else if (level<=low)
+	{	// beyond low limit
+		crossing=0;
+		direction=WARNING_LOW;
+	}	// beyond low limit
+	else if (trend>min_rate)
+	{	// rising
+		crossing=(uint32_t)((high-level)*1000/trend);
+		direction=WARNING_HIGH;
+	}	// rising
+	else if (trend<-min_rate)
+	{	// falling
+		crossing=(uint32_t)((level-low)*1000/(-trend));
+		direction=WARNING_LOW;
+	}	// falling
+	if (crossing<=config.lead)
+		state=direction;
+	if (state!=warning)
+	{	// report change
+		warning=state;
+		if (callback)
+			callback(*this,warning,crossing,context);
+	}	// report change
+}	// forecast
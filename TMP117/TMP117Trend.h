@@ -0,0 +1,75 @@
+#ifndef _TMP117_TREND_
+#define _TMP117_TREND_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "TMP117.h"
+
+/* *********************************************************************
+ * linear trend and time to threshold forecast
+ *
+ * level and trend are smoothed exponentially (Holt) in fixed point for
+ * irregular sample intervals. From the trend the time until the
+ * temperature crosses the high or low limit of the chip (shadow
+ * registers) is forecast, a warning is reported by callback when the
+ * crossing is expected within the lead time.
+ * ********************************************************************* */
+
+class TMP117Trend
+{
+	public:
+		static const uint32_t	NO_CROSSING		=UINT32_MAX;
+		static const uint8_t	FRACTION_BITS	=4;			// additional fraction bits of level and trend
+		static const uint8_t	MIN_SAMPLES		=3;			// samples before forecasting
+		static const uint32_t	MAX_GAP			=60000;		// ms, longer gaps restart estimation
+		
+		typedef enum:uint8_t {	WARNING_NONE,				// no crossing within lead time
+								WARNING_HIGH,				// high limit will be exceeded
+								WARNING_LOW					// temperature will fall below low limit
+								} warning_et;
+		
+		typedef void (*warning_cb_t)(TMP117Trend & trend, warning_et warning, uint32_t crossingMs, void * context);
+		
+		typedef struct config_s {	uint8_t		alpha;			// 1/256, level smoothing
+									uint8_t		beta;			// 1/256, trend smoothing
+									uint32_t	lead;			// ms, warn if crossing is forecast within
+									uint16_t	minRate;		// IQ9.7 per second, no forecast for slower trends
+								}	config_st;
+		
+		static const config_st	DEFAULT_CONFIG;	// 0.5, 0.125, 10s, 0.05°C/s
+		
+		TMP117Trend(TMP117 & sensor);
+		
+		void begin(	warning_cb_t callback=NULL, void * context=NULL, 
+					const config_st & config=DEFAULT_CONFIG);
+		void reset(void);								// restart estimation
+		
+		bool process_idle(void);						// reads temperature when due, true if idle
+		void update(int16_t temp, uint32_t timestamp);	// feed sample read elsewhere (IQ9.7, ms)
+		
+		int16_t getLevel(void);							// smoothed temperature in IQ9.7
+		int16_t getTrend(void);							// IQ9.7 per second
+		int16_t getForecast(uint32_t ms);				// IQ9.7, ms after last sample
+		uint32_t predictedCrossingMs(void);				// ms from now until a limit is crossed, 
+														// 0 if beyond, NO_CROSSING if not forecast
+		warning_et getWarning(void);
+		uint32_t getSamples(void);
+		
+	private:
+		TMP117 &		sensor;
+		config_st		config;
+		warning_cb_t	callback;
+		void *			context;
+		
+		int32_t			level;						// IQ9.7 with FRACTION_BITS
+		int32_t			trend;						// IQ9.7 per second with FRACTION_BITS
+		uint32_t		last_sample;				// ms
+		uint32_t		samples;
+		uint32_t		crossing;					// ms after last sample
+		warning_et		direction;					// limit of forecast crossing
+		warning_et		warning;
+		
+		void forecast(void);						// crossing and warning from level and trend
+};
+
+#endif // _TMP117_TREND_
@@ -0,0 +1,146 @@
+#ifndef _TMP117_WIRE_TRANSPORT_
+#define _TMP117_WIRE_TRANSPORT_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <Arduino.h>
+#include <Wire.h>
+
+/* *********************************************************************
+ * default transport: Arduino TwoWire
+ *
+ * all functions are inline and non virtual, a second bus is used by
+ * passing another TwoWire object to the constructor.
+ * isStuck() reports a timeout of the last transfer or SDA held low,
+ * recover() clocks out a slave holding SDA low if the pins are known
+ * and restarts TwoWire. Clock changes have to be done by setClock()
+ * of the transport to be restored after the restart (read back from
+ * TwoWire on ESP32)
+ * ********************************************************************* */
+
+class TMP117WireTransport
+{
+	public:
+		static const uint8_t	NO_PIN			=0xFF;
+		static const uint8_t	RECOVERY_CLOCKS	=9;			// a slave releases SDA within one byte
+		
+#if defined(PIN_WIRE_SDA) && defined(PIN_WIRE_SCL)
+		TMP117WireTransport(TwoWire & wire=Wire, uint8_t sda=PIN_WIRE_SDA, uint8_t scl=PIN_WIRE_SCL) : 
+#else
+		TMP117WireTransport(TwoWire & wire=Wire, uint8_t sda=NO_PIN, uint8_t scl=NO_PIN) : 
+#endif
+			wire(wire), sda(sda), scl(scl), clock(0), error(0) {}
+
+		static TMP117WireTransport & getDefault(void)	// transport on global Wire object
+		{	// getDefault
+			static TMP117WireTransport transport;
+			return transport;
+		}	// getDefault
+
+		inline bool probe(uint8_t addr)					// address acknowledged
+		{	// probe
+			wire.beginTransmission(addr);
+			return end(true);
+		}	// probe
+
+		inline bool writePointer(uint8_t addr, uint8_t reg)
+		{	// writePointer
+			wire.beginTransmission(addr);
+			wire.write(reg);
+			return end(true);
+		}	// writePointer
+
+		inline bool readData(uint8_t addr, uint16_t & data)	// read register selected by pointer
+		{	// readData
+			error=0;							// no error code, SDA is checked by isStuck()
+			if (wire.requestFrom(addr,(uint8_t)2)!=2)
+				return false;
+			data=(uint8_t)wire.read();
+			data<<=8;
+			data|=(uint8_t)wire.read();
+			return true;
+		}	// readData
+
+		inline bool readRegister(uint8_t addr, uint8_t reg, uint16_t & data)	// pointer and data with repeated start
+		{	// readRegister
+			wire.beginTransmission(addr);
+			wire.write(reg);
+			if (!end(false))
+				return false;
+			return readData(addr,data);
+		}	// readRegister
+
+		inline bool writeRegister(uint8_t addr, uint8_t reg, uint16_t data)
+		{	// writeRegister
+			wire.beginTransmission(addr);
+			wire.write(reg);
+			wire.write((data>>8)&0x00FF);
+			wire.write(data&0x00FF);
+			return end(true);
+		}	// writeRegister
+
+		void setClock(uint32_t clock)					// set clock, restored after recovery
+		{	// setClock
+			this->clock=clock;
+			wire.setClock(clock);
+		}	// setClock
+
+		inline bool isStuck(void)						// last failed transfer timed out or SDA held low
+		{	// isStuck
+			// endTransmission: 4 other error (AVR: bus timeout), 5 timeout
+			if ((error==4) || (error==5))
+				return true;
+			return (sda!=NO_PIN) && !digitalRead(sda);
+		}	// isStuck
+
+		bool recover(void)								// release stuck bus, restart TwoWire
+		{	// recover
+			bool released=true;
+			uint32_t restore=clock;
+#if defined(ARDUINO_ARCH_ESP32)
+			if (!restore)
+				restore=wire.getClock();		// set by Wire.setClock()
+#endif
+			wire.end();
+			if ((sda!=NO_PIN) && (scl!=NO_PIN))
+			{	// pins known
+				pinMode(sda,INPUT_PULLUP);
+				pinMode(scl,INPUT_PULLUP);
+				for (uint8_t n=0; (n<RECOVERY_CLOCKS) && !digitalRead(sda); n++)
+				{	// clock pulse, open drain
+					digitalWrite(scl,LOW);
+					pinMode(scl,OUTPUT);
+					delayMicroseconds(5);
+					pinMode(scl,INPUT_PULLUP);
+					delayMicroseconds(5);
+				}	// clock pulse, open drain
+				// stop condition: SDA rising while SCL high
+				digitalWrite(sda,LOW);
+				pinMode(sda,OUTPUT);
+				delayMicroseconds(5);
+				pinMode(sda,INPUT_PULLUP);
+				delayMicroseconds(5);
+				released=digitalRead(sda);
+			}	// pins known
+			wire.begin();
+			if (restore)
+				wire.setClock(restore);
+			error=0;
+			return released;
+		}	// recover
+
+	private:
+		TwoWire &	wire;
+		uint8_t		sda;
+		uint8_t		scl;
+		uint32_t	clock;						// 0: TwoWire default
+		uint8_t		error;						// endTransmission result of last transfer
+
+		inline bool end(bool stop)				// end transmission, keep error code
+		{	// end
+			error=wire.endTransmission(stop);
+			return !error;
+		}	// end
+};
+
+#endif // _TMP117_WIRE_TRANSPORT_
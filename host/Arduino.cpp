@@ -0,0 +1,154 @@
+#include "Arduino.h"
+
+static uint64_t		sim_us=0;
+static uint32_t		call_cost=1;
+static HostDevice *	devices=NULL;
+
+static uint8_t		pin_mode[HOST_PINS];
+static uint8_t		pin_output[HOST_PINS];
+static bool			pin_driven[HOST_PINS];
+static bool			pin_level[HOST_PINS];
+
+static void			(*pin_isr[HOST_PINS])(void);
+static uint8_t		pin_isr_mode[HOST_PINS];
+static bool			interrupts_enabled=true;
+
+HostDevice::HostDevice(void)
+{	// constructor
+	next=devices;
+	devices=this;
+}	// constructor
+
+HostDevice::~HostDevice(void)
+{	// destructor
+	HostDevice ** p=&devices;
+	while (*p && *p!=this)
+		p=&(*p)->next;
+	if (*p)
+		*p=next;
+}	// destructor
+
+uint32_t millis(void)
+{	// millis
+	hostAdvanceMicros(call_cost);
+	return (uint32_t)(sim_us/1000);
+}	// millis
+
+uint32_t micros(void)
+{	// micros
+	hostAdvanceMicros(call_cost);
+	return (uint32_t)sim_us;
+}	// micros
+
+size_t Print::write(const uint8_t * buffer, size_t size)
+{	// write, buffer
+	size_t n=0;
+	while ((n<size) && write(buffer[n]))
+		n++;
+	return n;
+}	// write, buffer
+
+int Print::availableForWrite(void)					// bytes writable without blocking
+{	// availableForWrite
+	return 0;
+}	// availableForWrite
+
+void delay(uint32_t ms)
+{	// delay
+	while (ms--)
+		hostAdvanceMicros(1000);
+}	// delay
+
+void delayMicroseconds(uint32_t us)
+{	// delayMicroseconds
+	hostAdvanceMicros(us);
+}	// delayMicroseconds
+
+void pinMode(uint8_t pin, uint8_t mode)
+{	// pinMode
+	if (pin<HOST_PINS)
+		pin_mode[pin]=mode;
+}	// pinMode
+
+int digitalRead(uint8_t pin)
+{	// digitalRead
+	if (pin>=HOST_PINS)
+		return LOW;
+	if (pin_driven[pin])
+		return pin_level[pin];
+	if (pin_mode[pin]==OUTPUT)
+		return pin_output[pin];
+	return (pin_mode[pin]==INPUT_PULLUP)?(HIGH):(LOW);
+}	// digitalRead
+
+void digitalWrite(uint8_t pin, uint8_t level)
+{	// digitalWrite
+	if (pin<HOST_PINS)
+		pin_output[pin]=level;
+}	// digitalWrite
+
+uint64_t hostMicros(void)							// simulated time
+{	// hostMicros
+	return sim_us;
+}	// hostMicros
+
+void hostAdvanceMicros(uint32_t us)					// advance simulated time
+{	// hostAdvanceMicros
+	static bool ticking=false;
+	sim_us+=us;
+	if (ticking)
+		return;			// called from ISR triggered by a device
+	ticking=true;
+	for (HostDevice * dev=devices; dev; dev=dev->next)
+		dev->tick(sim_us);
+	ticking=false;
+}	// hostAdvanceMicros
+
+void hostSetCallCost(uint32_t us)					// time advanced by each call to millis() / micros()
+{	// hostSetCallCost
+	call_cost=us;
+}	// hostSetCallCost
+
+void attachInterrupt(int interrupt, void (*isr)(void), int mode)
+{	// attachInterrupt
+	if ((interrupt>=0) && (interrupt<HOST_PINS))
+	{	// valid pin
+		pin_isr[interrupt]=isr;
+		pin_isr_mode[interrupt]=mode;
+	}	// valid pin
+}	// attachInterrupt
+
+void detachInterrupt(int interrupt)
+{	// detachInterrupt
+	if ((interrupt>=0) && (interrupt<HOST_PINS))
+		pin_isr[interrupt]=NULL;
+}	// detachInterrupt
+
+void noInterrupts(void)
+{	// noInterrupts
+	interrupts_enabled=false;
+}	// noInterrupts
+
+void interrupts(void)
+{	// interrupts
+	interrupts_enabled=true;
+}	// interrupts
+
+void hostDrivePin(uint8_t pin, bool driven, bool level)	// external driver on pin
+{	// hostDrivePin
+	if (pin<HOST_PINS)
+	{	// valid pin
+		int before=digitalRead(pin);
+		int after;
+		pin_driven[pin]=driven;
+		pin_level[pin]=level;
+		after=digitalRead(pin);
+		if (pin_isr[pin] && interrupts_enabled && (before!=after))
+		{	// edge
+			if (	(pin_isr_mode[pin]==CHANGE) ||
+					((pin_isr_mode[pin]==RISING) && after) ||
+					((pin_isr_mode[pin]==FALLING) && !after))
+				pin_isr[pin]();
+		}	// edge
+	}	// valid pin
+}	// hostDrivePin
@@ -0,0 +1,73 @@
+#ifndef _HOST_ARDUINO_
+#define _HOST_ARDUINO_
+
+/* *********************************************************************
+ * minimal Arduino core for host builds
+ * 
+ * time is simulated, it advances with delay(), with I2C transfers 
+ * and with every call to millis() / micros() to guarantee progress
+ * of polling loops
+ * ********************************************************************* */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HIGH			1
+#define LOW				0
+
+#define INPUT			0
+#define OUTPUT			1
+#define INPUT_PULLUP	2
+
+#define CHANGE			1
+#define FALLING			2
+#define RISING			3
+
+#define HOST_PINS		64
+
+#define digitalPinToInterrupt(pin)	(((pin)<HOST_PINS)?(pin):(-1))
+
+class HostDevice
+{	// simulated hardware, called whenever simulated time advances
+	public:
+		HostDevice(void);
+		virtual ~HostDevice(void);
+		virtual void tick(uint64_t now_us)=0;
+	private:
+		HostDevice * next;
+		friend void hostAdvanceMicros(uint32_t us);
+};
+
+class Print
+{	// byte output, e.g. serial port
+	public:
+		virtual ~Print(void) {}
+		virtual size_t write(uint8_t data)=0;
+		virtual size_t write(const uint8_t * buffer, size_t size);
+		virtual int availableForWrite(void);			// bytes writable without blocking
+};
+
+uint32_t millis(void);
+uint32_t micros(void);
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+
+void pinMode(uint8_t pin, uint8_t mode);
+int digitalRead(uint8_t pin);
+void digitalWrite(uint8_t pin, uint8_t level);
+
+void attachInterrupt(int interrupt, void (*isr)(void), int mode);
+void detachInterrupt(int interrupt);
+void noInterrupts(void);
+void interrupts(void);
+
+// simulation control
+uint64_t hostMicros(void);							// simulated time
+void hostAdvanceMicros(uint32_t us);				// advance simulated time
+void hostSetCallCost(uint32_t us);					// time advanced by each call to millis() / micros()
+void hostDrivePin(uint8_t pin, bool driven, bool level);	// external driver on pin
+
+#endif // _HOST_ARDUINO_
@@ -0,0 +1,184 @@
+#include "TMP117Replay.h"
+
+TMP117Replay::TMP117Replay(uint8_t addr, const uint8_t * trace, uint32_t length) : I2CDevice(addr)
+{	// constructor
+	TMP117Trace::record_st rec;
+	this->trace=trace;
+	count=length/TMP117Trace::RECORD_SIZE;
+	records=0;
+	for (uint32_t n=0; n<count; n++)
+	{	// count own records
+		TMP117Trace::decode(&trace[n*TMP117Trace::RECORD_SIZE],rec);
+		if (rec.address==addr)
+			records++;
+	}	// count own records
+	rewind();
+}	// constructor
+
+void TMP117Replay::rewind(void)
+{	// rewind
+	index=0;
+	position=0;
+	mismatches=0;
+	first_mismatch=NO_MISMATCH;
+	read_pending=false;
+	pointer=0;
+	memset(reg,0,sizeof(reg));
+	synced=false;
+	offset=0;
+	epoch=0;
+	last_timestamp=0;
+	// trace may start with failed attempts
+	inject_failures();
+}	// rewind
+
+bool TMP117Replay::isFinished(void)					// all records replayed
+{	// isFinished
+	return position>=records;
+}	// isFinished
+
+uint32_t TMP117Replay::getRecords(void)				// records of this address
+{	// getRecords
+	return records;
+}	// getRecords
+
+uint32_t TMP117Replay::getPosition(void)			// records replayed
+{	// getPosition
+	return position;
+}	// getPosition
+
+uint32_t TMP117Replay::getMismatches(void)			// operations differing from trace
+{	// getMismatches
+	return mismatches;
+}	// getMismatches
+
+uint32_t TMP117Replay::getFirstMismatch(void)		// position of first mismatch
+{	// getFirstMismatch
+	return first_mismatch;
+}	// getFirstMismatch
+
+void TMP117Replay::tick(uint64_t now_us)
+{	// tick
+	(void)now_us;
+}	// tick
+
+void TMP117Replay::i2cWrite(const uint8_t * data, uint8_t len)
+{	// i2cWrite
+	TMP117Trace::record_st rec;
+	bool valid=current(rec);
+	TMP117Trace::op_et op;
+	uint16_t val=0;
+	read_pending=false;
+	if (len)
+		pointer=data[0]%REGISTERS;
+	if (len>=3)
+	{	// register write
+		op=TMP117Trace::OP_WRITE;
+		val=((uint16_t)data[1]<<8)|data[2];
+		reg[pointer]=val;
+	}	// register write
+	else if (len)
+		// pointer alone or first phase of a read
+		op=(valid && (rec.op==TMP117Trace::OP_READ))?(TMP117Trace::OP_READ):(TMP117Trace::OP_POINTER);
+	else
+		op=TMP117Trace::OP_PROBE;
+	if (!valid)
+	{	// beyond end of trace
+		mismatch();
+		return;
+	}	// beyond end of trace
+	sync(rec.timestamp);
+	if (	(rec.op!=op) || 
+			((op!=TMP117Trace::OP_PROBE) && (rec.reg!=data[0])) ||
+			((op==TMP117Trace::OP_WRITE) && (rec.data!=val)))
+		mismatch();
+	if (op==TMP117Trace::OP_READ)
+		read_pending=true;
+	else
+		consume();
+}	// i2cWrite
+
+void TMP117Replay::i2cRead(uint8_t * data, uint8_t len)
+{	// i2cRead
+	TMP117Trace::record_st rec;
+	uint16_t val;
+	bool valid=current(rec);
+	if (	valid &&
+			(	(read_pending && (rec.op==TMP117Trace::OP_READ)) || 
+				(!read_pending && (rec.op==TMP117Trace::OP_READ_DATA))))
+	{	// expected read
+		if (!read_pending)
+			sync(rec.timestamp);
+		reg[pointer]=rec.data;
+		consume();
+	}	// expected read
+	else
+		mismatch();
+	read_pending=false;
+	val=reg[pointer];
+	for (uint8_t n=0; n<len; n++)
+		data[n]=(n==0)?(val>>8):((n==1)?(val&0xFF):(0xFF));
+}	// i2cRead
+
+/* *********************************************************************
+ * private functions
+ * ********************************************************************* */
+
+bool TMP117Replay::current(TMP117Trace::record_st & rec)	// next record of this address
+{	// current
+	while (index<count)
+	{	// search
+		TMP117Trace::decode(&trace[index*TMP117Trace::RECORD_SIZE],rec);
+		if (rec.address==getAddress())
+			return true;
+		index++;
+	}	// search
+	return false;
+}	// current
+
+void TMP117Replay::consume(void)					// next record, inject following failures
+{	// consume
+	index++;
+	position++;
+	inject_failures();
+}	// consume
+
+void TMP117Replay::inject_failures(void)			// failed attempts are replayed by the bus
+{	// inject_failures
+	TMP117Trace::record_st rec;
+	uint8_t failures=0;
+	while (current(rec) && !rec.ok && (failures<0xFF))
+	{	// skip failed attempts
+		failures++;
+		index++;
+		position++;
+	}	// skip failed attempts
+	if (failures)
+		Wire.injectNack(failures);
+}	// inject_failures
+
+void TMP117Replay::sync(uint32_t timestamp)			// advance host time to trace time
+{	// sync
+	uint64_t target;
+	if (synced && (timestamp<last_timestamp))
+		epoch+=(uint64_t)1<<32;
+	last_timestamp=timestamp;
+	if (!synced)
+	{	// first record defines time offset
+		offset=hostMicros()-timestamp;
+		synced=true;
+	}	// first record defines time offset
+	target=offset+epoch+timestamp;
+	while (hostMicros()<target)
+	{	// long gaps in steps
+		uint64_t step=target-hostMicros();
+		hostAdvanceMicros((step>0x7FFFFFFF)?(0x7FFFFFFF):((uint32_t)step));
+	}	// long gaps in steps
+}	// sync
+
+void TMP117Replay::mismatch(void)
+{	// mismatch
+	if (first_mismatch==NO_MISMATCH)
+		first_mismatch=position;
+	mismatches++;
+}	// mismatch
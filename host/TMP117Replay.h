@@ -0,0 +1,64 @@
+#ifndef _TMP117_REPLAY_
+#define _TMP117_REPLAY_
+
+/* *********************************************************************
+ * replay of a recorded TMP117Trace for host builds
+ *
+ * answers the driver from the records of its address instead of a
+ * chip model:
+ * - reads return the recorded data
+ * - failed attempts are injected as NACK with Wire.injectNack()
+ * - the simulated time is advanced to the recorded timestamp of each
+ *   operation, waiting loops of the driver are skipped
+ * Operations differing from the trace are counted, their reads are 
+ * answered with the last register content seen in the trace.
+ * ********************************************************************* */
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "TMP117Trace.h"
+
+class TMP117Replay : public I2CDevice
+{
+	public:
+		TMP117Replay(uint8_t addr, const uint8_t * trace, uint32_t length);	// length in bytes
+		
+		void rewind(void);
+		bool isFinished(void);							// all records replayed
+		uint32_t getRecords(void);						// records of this address
+		uint32_t getPosition(void);						// records replayed
+		uint32_t getMismatches(void);					// operations differing from trace
+		uint32_t getFirstMismatch(void);				// position of first mismatch
+		
+		virtual void tick(uint64_t now_us);
+		virtual void i2cWrite(const uint8_t * data, uint8_t len);
+		virtual void i2cRead(uint8_t * data, uint8_t len);
+		
+	private:
+		static const uint8_t	REGISTERS		=16;
+		static const uint32_t	NO_MISMATCH		=0xFFFFFFFF;
+	
+		const uint8_t *	trace;
+		uint32_t		count;						// records in trace, all addresses
+		uint32_t		index;						// next record in trace
+		uint32_t		records;
+		uint32_t		position;
+		uint32_t		mismatches;
+		uint32_t		first_mismatch;
+		bool			read_pending;				// pointer phase of OP_READ done
+		uint8_t			pointer;
+		uint16_t		reg[REGISTERS];				// last content seen in trace
+		
+		bool			synced;
+		uint64_t		offset;						// host time - trace time
+		uint64_t		epoch;						// trace time, wraps of 32 bit timestamp
+		uint32_t		last_timestamp;
+		
+		bool current(TMP117Trace::record_st & rec);	// next record of this address
+		void consume(void);							// next record, inject following failures
+		void inject_failures(void);					// failed attempts are replayed by the bus
+		void sync(uint32_t timestamp);				// advance host time to trace time
+		void mismatch(void);
+};
+
+#endif // _TMP117_REPLAY_
@@ -0,0 +1,260 @@
+#include <math.h>
+#include "TMP117Sim.h"
+
+TMP117Sim::TMP117Sim(uint8_t addr) : I2CDevice(addr)
+{	// constructor
+	memset(eeprom,0,sizeof(eeprom));
+	// factory defaults
+	eeprom[1]=0x0220;		// continuous, 1s, 8x averaging
+	eeprom[2]=0x6000;		// 192°C
+	eeprom[3]=0x8000;		// -256°C
+	eeprom[15]=0x0117;
+	profile=NULL;
+	temperature=25.0;
+	alert_pin=0xFF;
+	eeprom_writes=0;
+	powerUp();
+}	// constructor
+
+void TMP117Sim::setTemperature(double celsius)		// constant temperature
+{	// setTemperature
+	temperature=celsius;
+	profile=NULL;
+}	// setTemperature
+
+void TMP117Sim::setProfile(profile_ft profile)		// temperature over simulated time
+{	// setProfile
+	this->profile=profile;
+}	// setProfile
+
+void TMP117Sim::connectAlertPin(uint8_t pin)		// drive pin with the ALERT output
+{	// connectAlertPin
+	alert_pin=pin;
+	update_pin();
+}	// connectAlertPin
+
+void TMP117Sim::powerUp(void)						// power on reset, loads EEPROM
+{	// powerUp
+	now=hostMicros();
+	memset(reg,0,sizeof(reg));
+	reg[0]=0x8000;			// -256°C until first conversion
+	pointer=0;
+	conversions=0;
+	load_eeprom();
+}	// powerUp
+
+uint16_t TMP117Sim::getRegister(uint8_t addr)		// register content without side effects
+{	// getRegister
+	return (addr<REGISTERS)?(reg[addr]):(0);
+}	// getRegister
+
+uint16_t TMP117Sim::getEeprom(uint8_t addr)		// EEPROM content for registers backed by EEPROM
+{	// getEeprom
+	return (addr<REGISTERS)?(eeprom[addr]):(0);
+}	// getEeprom
+
+uint32_t TMP117Sim::getConversionCount(void)
+{	// getConversionCount
+	return conversions;
+}	// getConversionCount
+
+uint32_t TMP117Sim::getEepromWriteCount(void)
+{	// getEepromWriteCount
+	return eeprom_writes;
+}	// getEepromWriteCount
+
+void TMP117Sim::tick(uint64_t now_us)
+{	// tick
+	now=now_us;
+	if (busy_until && now>=busy_until)
+	{	// EEPROM operation finished
+		busy_until=0;
+		reg[1]&=~CFG_EEPROM_BUSY;
+		reg[4]&=~EEPROM_BUSY;
+		start_conversion();
+	}	// EEPROM operation finished
+	while (!busy_until && converting && now>=conversion_end)
+	{	// conversion finished
+		finish_conversion();
+		if (mode()==0)
+		{	// continuous: next cycle
+			cycle_start+=cycle_us();
+			conversion_end=cycle_start+active_us();
+		}	// continuous: next cycle
+		else
+		{	// one shot: return to shutdown
+			reg[1]=(reg[1]&~0x0C00)|0x0400;
+			converting=false;
+		}	// one shot: return to shutdown
+	}	// conversion finished
+	update_pin();
+}	// tick
+
+void TMP117Sim::i2cWrite(const uint8_t * data, uint8_t len)
+{	// i2cWrite
+	tick(hostMicros());
+	if (len>=1)
+		pointer=data[0]&0x0F;
+	if (len>=3)
+		write_register(pointer,((uint16_t)data[1]<<8)|data[2]);
+}	// i2cWrite
+
+void TMP117Sim::i2cRead(uint8_t * data, uint8_t len)
+{	// i2cRead
+	uint16_t val;
+	tick(hostMicros());
+	val=reg[pointer];
+	for (uint8_t n=0; n<len; n++)
+		data[n]=(n&1)?(val&0xFF):(val>>8);
+	switch (pointer)
+	{	// read side effects
+		case 0:
+			reg[1]&=~CFG_DATA_READY;
+			break;
+		case 1:
+			reg[1]&=~CFG_DATA_READY;
+			if (!(reg[1]&0x0010))
+				// alert mode, flags are cleared by reading
+				reg[1]&=~(CFG_HIGH_ALERT|CFG_LOW_ALERT);
+			break;
+		default:
+			break;
+	}	// read side effects
+	update_pin();
+}	// i2cRead
+
+/* *********************************************************************
+ * private functions
+ * ********************************************************************* */
+
+uint8_t TMP117Sim::mode(void)
+{	// mode
+	uint8_t mod=(reg[1]>>10)&0x03;
+	return (mod==2)?(0):(mod);
+}	// mode
+
+uint32_t TMP117Sim::active_us(void)				// conversion time for averaging
+{	// active_us
+	static const uint32_t duration[]={15500,125000,500000,1000000};
+	return duration[(reg[1]>>5)&0x03];
+}	// active_us
+
+uint32_t TMP117Sim::cycle_us(void)					// conversion cycle time
+{	// cycle_us
+	static const uint32_t cycle[]={15500,125000,250000,500000,1000000,4000000,8000000,16000000};
+	uint32_t c=cycle[(reg[1]>>7)&0x07];
+	return (c>active_us())?(c):(active_us());
+}	// cycle_us
+
+double TMP117Sim::sample(uint64_t t_us)
+{	// sample
+	return (profile)?(profile(t_us/1e6)):(temperature);
+}	// sample
+
+void TMP117Sim::start_conversion(void)
+{	// start_conversion
+	converting=(mode()!=1);
+	cycle_start=now;
+	conversion_end=now+active_us();
+}	// start_conversion
+
+void TMP117Sim::finish_conversion(void)
+{	// finish_conversion
+	// averaging over the active conversion time
+	const uint8_t points=8;
+	double sum=0;
+	long iq;
+	for (uint8_t n=0; n<points; n++)
+		sum+=sample(conversion_end-active_us()+(active_us()*(n+1))/points);
+	iq=lround(sum/points*128.0)+(int16_t)reg[7];
+	if (iq>32767) iq=32767;
+	if (iq<-32768) iq=-32768;
+	reg[0]=(uint16_t)(int16_t)iq;
+	conversions++;
+	reg[1]|=CFG_DATA_READY;
+	if (reg[1]&0x0010)
+	{	// therm mode, flag with hysteresis
+		if ((int16_t)reg[0]>(int16_t)reg[2])
+			reg[1]|=CFG_HIGH_ALERT;
+		else if ((int16_t)reg[0]<(int16_t)reg[3])
+			reg[1]&=~CFG_HIGH_ALERT;
+	}	// therm mode, flag with hysteresis
+	else
+	{	// alert mode, flags latched until read
+		if ((int16_t)reg[0]>(int16_t)reg[2])
+			reg[1]|=CFG_HIGH_ALERT;
+		if ((int16_t)reg[0]<(int16_t)reg[3])
+			reg[1]|=CFG_LOW_ALERT;
+	}	// alert mode, flags latched until read
+}	// finish_conversion
+
+void TMP117Sim::write_register(uint8_t addr, uint16_t val)
+{	// write_register
+	bool eun=reg[4]&EEPROM_EUN;
+	if (busy_until)
+		return;				// ignored during EEPROM operation
+	switch (addr)
+	{	// switch register
+		case 1:
+			if (val&CFG_SOFT_RESET)
+			{	// soft reset reloads EEPROM
+				memset(reg,0,sizeof(reg));
+				reg[0]=0x8000;
+				pointer=0;
+				load_eeprom();
+				return;
+			}	// soft reset reloads EEPROM
+			reg[1]=(reg[1]&~CFG_WRITABLE)|(val&CFG_WRITABLE);
+			start_conversion();
+			break;
+		case 2:
+		case 3:
+		case 5:
+		case 6:
+		case 7:
+		case 8:
+			reg[addr]=val;
+			break;
+		case 4:
+			reg[4]=(reg[4]&~EEPROM_EUN)|(val&EEPROM_EUN);
+			return;
+		default:
+			return;			// read only
+	}	// switch register
+	if (eun)
+	{	// program EEPROM
+		eeprom[addr]=(addr==1)?(val&CFG_WRITABLE):(val);
+		eeprom_writes++;
+		busy_until=now+EEPROM_WRITE_US;
+		reg[1]|=CFG_EEPROM_BUSY;
+		reg[4]|=EEPROM_BUSY;
+	}	// program EEPROM
+}	// write_register
+
+void TMP117Sim::load_eeprom(void)
+{	// load_eeprom
+	for (uint8_t n=1; n<REGISTERS; n++)
+		if (n!=4)
+			reg[n]=eeprom[n];
+	reg[1]|=CFG_EEPROM_BUSY;
+	reg[4]|=EEPROM_BUSY;
+	converting=false;
+	busy_until=now+EEPROM_LOAD_US;
+}	// load_eeprom
+
+void TMP117Sim::update_pin(void)
+{	// update_pin
+	bool active;
+	if (alert_pin==0xFF)
+		return;
+	if (reg[1]&0x0004)
+		active=reg[1]&CFG_DATA_READY;
+	else
+		active=reg[1]&(CFG_HIGH_ALERT|CFG_LOW_ALERT);
+	if (reg[1]&0x0008)
+		// active high, open drain released
+		hostDrivePin(alert_pin,!active,false);
+	else
+		// active low, open drain pulls low
+		hostDrivePin(alert_pin,active,false);
+}	// update_pin
@@ -0,0 +1,85 @@
+#ifndef _TMP117_SIM_
+#define _TMP117_SIM_
+
+/* *********************************************************************
+ * register accurate model of the TMP117 for host builds
+ *
+ * - register file REG_TEMPERATURE ... REG_DEVICE_ID with pointer register
+ * - conversion timing for conversion cycle time and averaging
+ * - continuous, shutdown and one-shot conversion
+ * - data ready and alert flags cleared on read, therm mode hysteresis
+ * - EEPROM with unlock, 7ms busy window and reload on soft reset
+ * - ALERT pin with selectable source and polarity
+ * ********************************************************************* */
+
+#include "Arduino.h"
+#include "Wire.h"
+
+class TMP117Sim : public I2CDevice
+{
+	public:
+		typedef double (*profile_ft)(double seconds);	// temperature in °C over time
+		
+		static const uint16_t	EEPROM_WRITE_US	=7000;	// EEPROM programming time
+		static const uint16_t	EEPROM_LOAD_US	=1500;	// EEPROM load after reset / power up
+	
+		TMP117Sim(uint8_t addr);
+		
+		void setTemperature(double celsius);			// constant temperature
+		void setProfile(profile_ft profile);			// temperature over simulated time
+		void connectAlertPin(uint8_t pin);				// drive pin with the ALERT output
+		void powerUp(void);								// power on reset, loads EEPROM
+		
+		uint16_t getRegister(uint8_t reg);				// register content without side effects
+		uint16_t getEeprom(uint8_t reg);				// EEPROM content for registers backed by EEPROM
+		uint32_t getConversionCount(void);				// finished conversions since power up
+		uint32_t getEepromWriteCount(void);				// EEPROM programming cycles since construction
+		
+		virtual void tick(uint64_t now_us);
+		virtual void i2cWrite(const uint8_t * data, uint8_t len);
+		virtual void i2cRead(uint8_t * data, uint8_t len);
+		
+	private:
+	
+		static const uint8_t	REGISTERS		=16;
+		
+		// configuration register bits
+		static const uint16_t	CFG_HIGH_ALERT	=0x8000;
+		static const uint16_t	CFG_LOW_ALERT	=0x4000;
+		static const uint16_t	CFG_DATA_READY	=0x2000;
+		static const uint16_t	CFG_EEPROM_BUSY	=0x1000;
+		static const uint16_t	CFG_WRITABLE	=0x0FFC;
+		static const uint16_t	CFG_SOFT_RESET	=0x0002;
+		
+		static const uint16_t	EEPROM_EUN		=0x8000;
+		static const uint16_t	EEPROM_BUSY		=0x4000;
+	
+		uint16_t	reg[REGISTERS];
+		uint16_t	eeprom[REGISTERS];
+		uint8_t		pointer;
+		
+		profile_ft	profile;
+		double		temperature;
+		
+		uint64_t	now;
+		uint64_t	cycle_start;
+		uint64_t	conversion_end;
+		bool		converting;
+		uint64_t	busy_until;
+		
+		uint8_t		alert_pin;
+		uint32_t	conversions;
+		uint32_t	eeprom_writes;
+		
+		uint8_t mode(void);
+		uint32_t active_us(void);						// conversion time for averaging
+		uint32_t cycle_us(void);						// conversion cycle time
+		double sample(uint64_t t_us);
+		void start_conversion(void);
+		void finish_conversion(void);
+		void write_register(uint8_t addr, uint16_t val);
+		void load_eeprom(void);
+		void update_pin(void);
+};
+
+#endif // _TMP117_SIM_
@@ -0,0 +1,124 @@
+#include <string.h>
+#include "TMP117TelemetryDecoder.h"
+
+static uint32_t get32(const uint8_t * data)
+{	// get32
+	return (uint32_t)data[0] | ((uint32_t)data[1]<<8) | ((uint32_t)data[2]<<16) | ((uint32_t)data[3]<<24);
+}	// get32
+
+static uint16_t get16(const uint8_t * data)
+{	// get16
+	return (uint16_t)data[0] | ((uint16_t)data[1]<<8);
+}	// get16
+
+TMP117TelemetryDecoder::TMP117TelemetryDecoder(sample_ft onSample, void * context)
+{	// constructor
+	on_sample=onSample;
+	this->context=context;
+	reset();
+}	// constructor
+
+void TMP117TelemetryDecoder::reset(void)
+{	// reset
+	length=0;
+	frames=0;
+	samples=0;
+	crc_errors=0;
+	skipped=0;
+}	// reset
+
+void TMP117TelemetryDecoder::finish(void)			// end of stream, truncated frame is skipped
+{	// finish
+	decode(true);
+}	// finish
+
+uint32_t TMP117TelemetryDecoder::getFrames(void)	// valid frames
+{	// getFrames
+	return frames;
+}	// getFrames
+
+uint32_t TMP117TelemetryDecoder::getSamples(void)
+{	// getSamples
+	return samples;
+}	// getSamples
+
+uint32_t TMP117TelemetryDecoder::getCrcErrors(void)
+{	// getCrcErrors
+	return crc_errors;
+}	// getCrcErrors
+
+uint32_t TMP117TelemetryDecoder::getSkipped(void)	// bytes outside valid frames
+{	// getSkipped
+	return skipped;
+}	// getSkipped
+
+size_t TMP117TelemetryDecoder::write(uint8_t data)
+{	// write
+	return write(&data,1);
+}	// write
+
+size_t TMP117TelemetryDecoder::write(const uint8_t * buffer, size_t size)
+{	// write, buffer
+	size_t done=0;
+	while (done<size)
+	{	// fill and decode
+		size_t n=sizeof(this->buffer)-length;
+		if (n>size-done)
+			n=size-done;
+		memcpy(&this->buffer[length],&buffer[done],n);
+		length+=n;
+		done+=n;
+		// leaves less than one frame
+		decode(false);
+	}	// fill and decode
+	return size;
+}	// write, buffer
+
+/* *********************************************************************
+ * private functions
+ * ********************************************************************* */
+
+void TMP117TelemetryDecoder::decode(bool eof)		// all complete frames in buffer
+{	// decode
+	while (length)
+	{	// frames
+		uint16_t size;
+		if ((length<2) || ((buffer[0]==TMP117Telemetry::SYNC_0) && (length<TMP117Telemetry::HEADER_SIZE)))
+			size=0;
+		else if ((buffer[0]!=TMP117Telemetry::SYNC_0) || (buffer[1]!=TMP117Telemetry::SYNC_1))
+			size=1;
+		else
+			size=TMP117Telemetry::HEADER_SIZE+2*buffer[3]+TMP117Telemetry::CRC_SIZE;
+		if (!size || (size>length))
+		{	// truncated frame
+			if (!eof)
+				return;
+			// end of stream, may be a false sync before complete frames
+			size=1;
+		}	// truncated frame
+		if (size==1)
+			skipped++;
+		else if (TMP117Telemetry::crc16(&buffer[2],size-4)!=get16(&buffer[size-2]))
+		{	// corrupt frame, search next sync
+			crc_errors++;
+			skipped++;
+			size=1;
+		}	// corrupt frame, search next sync
+		else
+			sample_frame();
+		memmove(buffer,&buffer[size],length-size);
+		length-=size;
+	}	// frames
+}	// decode
+
+void TMP117TelemetryDecoder::sample_frame(void)		// pass samples of frame at start of buffer
+{	// sample_frame
+	uint8_t id=buffer[2];
+	uint32_t timestamp=get32(&buffer[4]);
+	uint16_t interval=get16(&buffer[8]);
+	for (uint8_t s=0; s<buffer[3]; s++)
+		if (on_sample)
+			on_sample(id,timestamp+(uint32_t)s*interval,(int16_t)get16(&buffer[TMP117Telemetry::HEADER_SIZE+2*s]),context);
+	frames++;
+	samples+=buffer[3];
+}	// sample_frame
@@ -0,0 +1,52 @@
+#ifndef _TMP117_TELEMETRY_DECODER_
+#define _TMP117_TELEMETRY_DECODER_
+
+/* *********************************************************************
+ * decoder of TMP117Telemetry frames for host builds
+ *
+ * takes the byte stream as Print output, either captured data or
+ * directly as output of TMP117Telemetry, synchronizes on the frame
+ * header and checks the CRC of every frame. The samples of valid frames
+ * are passed to the callback with the timestamp reconstructed from the
+ * mean interval, bytes outside valid frames are skipped and counted.
+ * ********************************************************************* */
+
+#include "Arduino.h"
+#include "TMP117Telemetry.h"
+
+class TMP117TelemetryDecoder : public Print
+{
+	public:
+		typedef void (*sample_ft)(uint8_t id, uint32_t timestamp, int16_t temp, void * context);
+		
+		TMP117TelemetryDecoder(sample_ft onSample, void * context=NULL);
+		
+		void reset(void);
+		void finish(void);								// end of stream, decode rest, truncated frame is skipped
+		
+		uint32_t getFrames(void);						// valid frames
+		uint32_t getSamples(void);
+		uint32_t getCrcErrors(void);
+		uint32_t getSkipped(void);						// bytes outside valid frames
+		
+		virtual size_t write(uint8_t data);
+		virtual size_t write(const uint8_t * buffer, size_t size);
+		
+	private:
+		static const uint16_t	MAX_FRAME		=TMP117Telemetry::HEADER_SIZE+2*255+TMP117Telemetry::CRC_SIZE;
+		
+		sample_ft		on_sample;
+		void *			context;
+		uint8_t			buffer[2*MAX_FRAME];
+		uint16_t		length;
+		
+		uint32_t		frames;
+		uint32_t		samples;
+		uint32_t		crc_errors;
+		uint32_t		skipped;
+		
+		void decode(bool eof);						// all complete frames in buffer
+		void sample_frame(void);					// pass samples of frame at start of buffer
+};
+
+#endif // _TMP117_TELEMETRY_DECODER_
@@ -0,0 +1,202 @@
+#include "Wire.h"
+
+TwoWire Wire;
+
+I2CDevice * TwoWire::devices=NULL;
+
+I2CDevice::I2CDevice(uint8_t addr)
+{	// constructor
+	address=addr;
+	next=TwoWire::devices;
+	TwoWire::devices=this;
+}	// constructor
+
+I2CDevice::~I2CDevice(void)
+{	// destructor
+	I2CDevice ** p=&TwoWire::devices;
+	while (*p && *p!=this)
+		p=&(*p)->next;
+	if (*p)
+		*p=next;
+}	// destructor
+
+uint8_t I2CDevice::getAddress(void)
+{	// getAddress
+	return address;
+}	// getAddress
+
+TwoWire::TwoWire(void)
+{	// constructor
+	clock=100000;
+	tx_address=0;
+	tx_length=0;
+	rx_length=0;
+	rx_index=0;
+	nack_count=0;
+	stuck=false;
+	resetStats();
+}	// constructor
+
+void TwoWire::begin(void)
+{	// begin
+	clock=100000;						// like AVR, the clock is set again after begin
+	tx_length=0;
+	rx_length=0;
+	rx_index=0;
+	stuck=false;
+}	// begin
+
+void TwoWire::end(void)
+{	// end
+}	// end
+
+void TwoWire::setClock(uint32_t clock)
+{	// setClock
+	this->clock=clock;
+}	// setClock
+
+uint32_t TwoWire::getClock(void)
+{	// getClock
+	return clock;
+}	// getClock
+
+void TwoWire::beginTransmission(uint8_t addr)
+{	// beginTransmission
+	tx_address=addr;
+	tx_length=0;
+}	// beginTransmission
+
+uint8_t TwoWire::endTransmission(bool sendStop)
+{	// endTransmission
+	I2CDevice * dev=find(tx_address);
+	(void)sendStop;
+	if (fault())
+	{	// injected failure
+		tx_length=0;
+		return (stuck)?(4):(2);
+	}	// injected failure
+	if (!dev)
+	{	// address nack
+		bus_time(0);
+		return 2;
+	}	// address nack
+	bus_time(tx_length);
+	dev->i2cWrite(tx_buffer,tx_length);
+	tx_length=0;
+	return 0;
+}	// endTransmission
+
+uint8_t TwoWire::requestFrom(uint8_t addr, uint8_t quantity, bool sendStop)
+{	// requestFrom
+	I2CDevice * dev=find(addr);
+	(void)sendStop;
+	rx_index=0;
+	rx_length=0;
+	if (quantity>HOST_WIRE_BUFFER)
+		quantity=HOST_WIRE_BUFFER;
+	if (fault())
+		return 0;
+	if (dev)
+	{	// device acks
+		bus_time(quantity);
+		dev->i2cRead(rx_buffer,quantity);
+		rx_length=quantity;
+	}	// device acks
+	else
+		bus_time(0);
+	return rx_length;
+}	// requestFrom
+
+uint8_t TwoWire::requestFrom(int addr, int quantity)
+{	// requestFrom
+	return requestFrom((uint8_t)addr,(uint8_t)quantity,true);
+}	// requestFrom
+
+size_t TwoWire::write(uint8_t data)
+{	// write
+	if (tx_length>=HOST_WIRE_BUFFER)
+		return 0;
+	tx_buffer[tx_length++]=data;
+	return 1;
+}	// write
+
+int TwoWire::available(void)
+{	// available
+	return rx_length-rx_index;
+}	// available
+
+int TwoWire::read(void)
+{	// read
+	return (rx_index<rx_length)?(rx_buffer[rx_index++]):(-1);
+}	// read
+
+void TwoWire::resetStats(void)
+{	// resetStats
+	transfers=0;
+	bytes=0;
+	bits=0;
+}	// resetStats
+
+uint32_t TwoWire::getTransfers(void)
+{	// getTransfers
+	return transfers;
+}	// getTransfers
+
+uint32_t TwoWire::getBytes(void)
+{	// getBytes
+	return bytes;
+}	// getBytes
+
+uint32_t TwoWire::getBits(void)
+{	// getBits
+	return bits;
+}	// getBits
+
+void TwoWire::injectNack(uint8_t count)				// next transfers are not acknowledged
+{	// injectNack
+	nack_count=count;
+}	// injectNack
+
+void TwoWire::setStuck(bool stuck)					// SDA held low, transfers time out until begin()
+{	// setStuck
+	this->stuck=stuck;
+}	// setStuck
+
+/* *********************************************************************
+ * private functions
+ * ********************************************************************* */
+
+I2CDevice * TwoWire::find(uint8_t addr)
+{	// find
+	I2CDevice * dev=devices;
+	while (dev && dev->address!=addr)
+		dev=dev->next;
+	return dev;
+}	// find
+
+void TwoWire::bus_time(uint8_t bytes)				// advance time for address + bytes
+{	// bus_time
+	// start, address + data bytes with ack, stop
+	uint32_t bits=2+9*(1+(uint32_t)bytes);
+	transfers++;
+	this->bytes+=bytes;
+	this->bits+=bits;
+	hostAdvanceMicros((bits*1000000UL+clock-1)/clock);
+}	// bus_time
+
+bool TwoWire::fault(void)							// injected failure of this transfer
+{	// fault
+	if (stuck)
+	{	// no clock on the bus, wait for timeout
+		transfers++;
+		hostAdvanceMicros(HOST_WIRE_TIMEOUT);
+		return true;
+	}	// no clock on the bus, wait for timeout
+	if (nack_count)
+	{	// address not acknowledged
+		nack_count--;
+		bus_time(0);
+		return true;
+	}	// address not acknowledged
+	return false;
+}	// fault
@@ -0,0 +1,82 @@
+#ifndef _HOST_WIRE_
+#define _HOST_WIRE_
+
+/* *********************************************************************
+ * Wire replacement for host builds
+ *
+ * transfers are routed to simulated devices, the simulated time
+ * advances by the duration of each transfer at the selected clock
+ * ********************************************************************* */
+
+#include "Arduino.h"
+
+#define HOST_WIRE_BUFFER	32
+#define HOST_WIRE_TIMEOUT	25000		// µs until a transfer on a stuck bus is aborted
+
+class I2CDevice : public HostDevice
+{	// simulated I2C slave
+	public:
+		I2CDevice(uint8_t addr);
+		virtual ~I2CDevice(void);
+		uint8_t getAddress(void);
+		virtual void i2cWrite(const uint8_t * data, uint8_t len)=0;	// master writes, address acked
+		virtual void i2cRead(uint8_t * data, uint8_t len)=0;			// master reads, address acked
+	private:
+		uint8_t		address;
+		I2CDevice *	next;
+		friend class TwoWire;
+};
+
+class TwoWire
+{
+	public:
+		TwoWire(void);
+		void begin(void);
+		void end(void);
+		void setClock(uint32_t clock);
+		
+		void beginTransmission(uint8_t addr);
+		uint8_t endTransmission(bool sendStop=true);	// 0: ok, 2: address nack, 4: timeout
+		uint8_t requestFrom(uint8_t addr, uint8_t quantity, bool sendStop=true);
+		uint8_t requestFrom(int addr, int quantity);
+		size_t write(uint8_t data);
+		int available(void);
+		int read(void);
+		
+		uint32_t getClock(void);
+		
+		// transfer accounting
+		void resetStats(void);
+		uint32_t getTransfers(void);					// address phases (start / repeated start)
+		uint32_t getBytes(void);						// data bytes without address
+		uint32_t getBits(void);							// clock cycles incl. start, ack and stop
+		
+		// fault injection
+		void injectNack(uint8_t count);					// next transfers are not acknowledged
+		void setStuck(bool stuck);						// SDA held low, transfers time out until begin()
+		
+	private:
+		uint32_t	clock;
+		uint8_t		tx_address;
+		uint8_t		tx_buffer[HOST_WIRE_BUFFER];
+		uint8_t		tx_length;
+		uint8_t		rx_buffer[HOST_WIRE_BUFFER];
+		uint8_t		rx_length;
+		uint8_t		rx_index;
+		uint32_t	transfers;
+		uint32_t	bytes;
+		uint32_t	bits;
+		uint8_t		nack_count;
+		bool		stuck;
+		
+		I2CDevice * find(uint8_t addr);
+		void bus_time(uint8_t bytes);					// advance time for address + bytes
+		bool fault(void);								// injected failure of this transfer
+		
+		friend class I2CDevice;
+		static I2CDevice * devices;
+};
+
+extern TwoWire Wire;
+
+#endif // _HOST_WIRE_
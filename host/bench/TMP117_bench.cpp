@@ -0,0 +1,137 @@
+/* *********************************************************************
+ * I2C cost of the public TMP117 interface
+ *
+ * every call runs against a freshly powered simulated chip, the 
+ * transfers are counted by the host Wire class. The report is written
+ * as CSV to stdout to be diffed between library versions.
+ * ********************************************************************* */
+
+// build from repository root:
+// g++ -std=c++11 -Ihost -ITMP117 host/*.cpp TMP117/*.cpp host/bench/TMP117_bench.cpp -o TMP117_bench
+
+#include <stdio.h>
+#include "Arduino.h"
+#include "Wire.h"
+#include "TMP117Sim.h"
+#include "TMP117.h"
+#include "TMP117Profile.h"
+
+#define ADDRESS		0x48
+#define ALERT_PIN	2
+#define NO_PIN		0xFF
+
+typedef void (*bench_ft)(TMP117 & sensor);
+
+typedef struct bench_s {	const char *	name;
+							uint8_t			alert_pin;
+							bool			init;		// call init() before measuring
+							bench_ft		run;
+						}	bench_st;
+
+static void drain(TMP117 & sensor)
+{	// drain
+	while (!sensor.process_idle());
+}	// drain
+
+static const bench_st bench[]={
+	// single calls
+	{"init",							NO_PIN,		false,	[](TMP117 & s){ s.init(); }},
+	{"init(profile)",					NO_PIN,		false,	[](TMP117 & s){ s.init(TMP117Profile<>::profile()); }},
+	{"init(profile,changes)",			NO_PIN,		false,	[](TMP117 & s){ uint8_t c; s.init(TMP117Profile<>::profile(),c); }},
+	{"process_idle",					NO_PIN,		true,	[](TMP117 & s){ s.process_idle(); }},
+	{"isAlert(no pin)",					NO_PIN,		true,	[](TMP117 & s){ s.isAlert(); }},
+	{"isAlert(pin)",					ALERT_PIN,	true,	[](TMP117 & s){ s.isAlert(); }},
+	{"getTemp()",						NO_PIN,		true,	[](TMP117 & s){ s.getTemp(); }},
+	{"getTemp(2)",						NO_PIN,		true,	[](TMP117 & s){ s.getTemp(2); }},
+	{"setHighTemperaturLimit",			NO_PIN,		true,	[](TMP117 & s){ s.setHighTemperaturLimit(3000,2); }},
+	{"setLowTemperaturLimit",			NO_PIN,		true,	[](TMP117 & s){ s.setLowTemperaturLimit(1000,2); }},
+	{"getHighTemperaturLimit",			NO_PIN,		true,	[](TMP117 & s){ s.getHighTemperaturLimit(); }},
+	{"getLowTemperaturLimit",			NO_PIN,		true,	[](TMP117 & s){ s.getLowTemperaturLimit(); }},
+	{"getDeviceID",						NO_PIN,		true,	[](TMP117 & s){ s.getDeviceID(); }},
+	{"getDeviceRevision",				NO_PIN,		true,	[](TMP117 & s){ s.getDeviceRevision(); }},
+	{"reset",							NO_PIN,		true,	[](TMP117 & s){ s.reset(); drain(s); }},
+	{"setAlertPinSource",				NO_PIN,		true,	[](TMP117 & s){ s.setAlertPinSource(TMP117::ALERT_PIN_DATA_READY); }},
+	{"setAlertPinPolarity",				NO_PIN,		true,	[](TMP117 & s){ s.setAlertPinPolarity(TMP117::ALERT_PIN_ACTIVE_HIGH); }},
+	{"setAlertMode",					NO_PIN,		true,	[](TMP117 & s){ s.setAlertMode(TMP117::ALERT_MODE_THERMISTOR); }},
+	{"setAveragingMode",				NO_PIN,		true,	[](TMP117 & s){ s.setAveragingMode(TMP117::AVERAGING_32); }},
+	{"setConversionTime",				NO_PIN,		true,	[](TMP117 & s){ s.setConversionTime(TMP117::CONVERSION_TIME_1_8s); }},
+	{"setConversionMode",				NO_PIN,		true,	[](TMP117 & s){ s.setConversionMode(TMP117::MODE_CONTINUOUS); }},
+	{"getAlertPinSource",				NO_PIN,		true,	[](TMP117 & s){ s.getAlertPinSource(); }},
+	{"getAlertPinPolarity",				NO_PIN,		true,	[](TMP117 & s){ s.getAlertPinPolarity(); }},
+	{"getAlertMode",					NO_PIN,		true,	[](TMP117 & s){ s.getAlertMode(); }},
+	{"getAveragingMode",				NO_PIN,		true,	[](TMP117 & s){ s.getAveragingMode(); }},
+	{"getConversionTime",				NO_PIN,		true,	[](TMP117 & s){ s.getConversionTime(); }},
+	{"getConversionMode",				NO_PIN,		true,	[](TMP117 & s){ s.getConversionMode(); }},
+	{"getConversionCycleTime",			NO_PIN,		true,	[](TMP117 & s){ s.getConversionCycleTime(); }},
+	{"readStatus",						NO_PIN,		true,	[](TMP117 & s){ s.readStatus(); }},
+	{"clearStatus",						NO_PIN,		true,	[](TMP117 & s){ s.clearStatus(); }},
+	{"isDataReady",						NO_PIN,		true,	[](TMP117 & s){ s.isDataReady(); }},
+	{"testHighTemperatureAlert",		NO_PIN,		true,	[](TMP117 & s){ s.testHighTemperatureAlert(); }},
+	{"testLowTemperatureAlert",			NO_PIN,		true,	[](TMP117 & s){ s.testLowTemperatureAlert(); }},
+	{"testEepromBusy",					NO_PIN,		true,	[](TMP117 & s){ s.testEepromBusy(); }},
+	{"testEepromLocked",				NO_PIN,		true,	[](TMP117 & s){ s.testEepromLocked(); }},
+	{"setEepromLockState",				NO_PIN,		true,	[](TMP117 & s){ s.setEepromLockState(TMP117::EEPROM_UNLOCK); }},
+	{"writeEeprom",						NO_PIN,		true,	[](TMP117 & s){ s.writeEeprom(TMP117::EEPROM_POS_1,0x1234); drain(s); }},
+	{"writeTemperatureOffset",			NO_PIN,		true,	[](TMP117 & s){ s.writeTemperatureOffset(0x0010); drain(s); }},
+	{"readEeprom",						NO_PIN,		true,	[](TMP117 & s){ s.readEeprom(TMP117::EEPROM_POS_1); }},
+	{"readTemperatureOffset",			NO_PIN,		true,	[](TMP117 & s){ s.readTemperatureOffset(); }},
+	{"queueRead",						NO_PIN,		true,	[](TMP117 & s){ uint16_t d; uint8_t h=s.queueRead(TMP117::REG_TEMPERATURE); drain(s); s.getTransactionResult(h,d); }},
+	{"queueWrite",						NO_PIN,		true,	[](TMP117 & s){ s.queueWrite(TMP117::REG_HIGH_TEMP_LIMIT,0x1000,[](TMP117 &, uint8_t, uint16_t, void *){}); drain(s); }},
+	{"requestMeasurement",				NO_PIN,		true,	[](TMP117 & s){ uint16_t d; uint8_t h=s.requestMeasurement(); drain(s); s.getTransactionResult(h,d); }},
+	// sequences
+	{"seq:configure continuous",		NO_PIN,		true,	[](TMP117 & s){	s.setAlertPinSource(TMP117::ALERT_PIN_DATA_READY);
+																			s.setAlertPinPolarity(TMP117::ALERT_PIN_ACTIVE_LOW);
+																			s.setAveragingMode(TMP117::AVERAGING_8);
+																			s.setConversionTime(TMP117::CONVERSION_TIME_1_8s);
+																			s.setHighTemperaturLimit(8000,2);
+																			s.setLowTemperaturLimit(-1000,2);
+																			s.setConversionMode(TMP117::MODE_CONTINUOUS); }},
+	{"seq:configure continuous batch",	NO_PIN,		true,	[](TMP117 & s){	s.beginConfig();
+																			s.setAlertPinSource(TMP117::ALERT_PIN_DATA_READY);
+																			s.setAlertPinPolarity(TMP117::ALERT_PIN_ACTIVE_LOW);
+																			s.setAveragingMode(TMP117::AVERAGING_8);
+																			s.setConversionTime(TMP117::CONVERSION_TIME_1_8s);
+																			s.setHighTemperaturLimit(8000,2);
+																			s.setLowTemperaturLimit(-1000,2);
+																			s.setConversionMode(TMP117::MODE_CONTINUOUS);
+																			s.commitConfig(); }},
+	{"seq:status and temperature",		NO_PIN,		true,	[](TMP117 & s){	s.isDataReady();
+																			s.testHighTemperatureAlert();
+																			s.testLowTemperatureAlert();
+																			s.getTemp(); }},
+	{"seq:readStatus with temperature",	NO_PIN,		true,	[](TMP117 & s){	// delay() has no bus traffic, first result is ready
+																			delay(s.getConversionCycleTime());
+																			s.readStatus(true); }},
+	{"seq:one-shot polling",			NO_PIN,		true,	[](TMP117 & s){	s.setConversionMode(TMP117::MODE_ONE_SHOT);
+																			while (!s.isDataReady());
+																			s.getTemp(); }},
+	{"seq:eeprom offset unlocked",		NO_PIN,		true,	[](TMP117 & s){	s.setEepromLockState(TMP117::EEPROM_UNLOCK);
+																			s.writeTemperatureOffset(0x0010);
+																			drain(s);
+																			s.setEepromLockState(TMP117::EEPROM_LOCK); }},
+};
+
+int main(void)
+{	// main
+	static const uint32_t clock[]={100000,400000,1000000};
+	
+	printf("name,transfers,bytes,bits,us_100kHz,us_400kHz,us_1MHz\n");
+	for (size_t n=0; n<sizeof(bench)/sizeof(bench[0]); n++)
+	{	// run benchmark
+		TMP117Sim sim(ADDRESS);
+		TMP117 sensor(ADDRESS,bench[n].alert_pin);
+		
+		sim.connectAlertPin(ALERT_PIN);
+		Wire.begin();
+		drain(sensor);					// power up
+		if (bench[n].init)
+			sensor.init();
+		Wire.resetStats();
+		bench[n].run(sensor);
+		printf("\"%s\",%u,%u,%u",bench[n].name,Wire.getTransfers(),Wire.getBytes(),Wire.getBits());
+		for (uint8_t c=0; c<sizeof(clock)/sizeof(clock[0]); c++)
+			printf(",%.1f",Wire.getBits()*1e6/clock[c]);
+		printf("\n");
+	}	// run benchmark
+	return 0;
+}	// main
@@ -0,0 +1,70 @@
+/* *********************************************************************
+ * decoder of TMP117Telemetry frames
+ *
+ * reads a captured byte stream (file or stdin) and decodes it with
+ * TMP117TelemetryDecoder, frames with CRC error are skipped. The samples
+ * are written as CSV to stdout or as binary array of packed records
+ * (id uint8_t, timestamp uint32_t, temp int16_t, little endian).
+ * Frame and error counts are reported to stderr.
+ * ********************************************************************* */
+
+// build from repository root:
+// g++ -std=c++11 -Ihost -ITMP117 host/Arduino.cpp host/TMP117TelemetryDecoder.cpp TMP117/TMP117Telemetry.cpp host/telemetry/TMP117_telemetry.cpp -o TMP117_telemetry
+
+#include <stdio.h>
+#include <string.h>
+#include "TMP117TelemetryDecoder.h"
+
+static void print_sample(uint8_t id, uint32_t timestamp, int16_t temp, void * context)
+{	// print_sample
+	bool binary=*(bool *)context;
+	if (binary)
+	{	// packed record
+		uint8_t record[7]={id,(uint8_t)timestamp,(uint8_t)(timestamp>>8),(uint8_t)(timestamp>>16),(uint8_t)(timestamp>>24),
+							(uint8_t)temp,(uint8_t)((uint16_t)temp>>8)};
+		fwrite(record,1,sizeof(record),stdout);
+	}	// packed record
+	else
+		printf("%u,%u,%d,%.4f\n",id,timestamp,temp,temp/128.0);
+}	// print_sample
+
+int main(int argc, char ** argv)
+{	// main
+	static uint8_t buffer[4096];
+	bool binary=false;
+	const char * name=NULL;
+	FILE * in=stdin;
+	TMP117TelemetryDecoder decoder(print_sample,&binary);
+	size_t size;
+	
+	for (int n=1; n<argc; n++)
+		if (!strcmp(argv[n],"-b"))
+			binary=true;
+		else if (!name)
+			name=argv[n];
+		else
+		{	// usage
+			fprintf(stderr,"usage: %s [-b] [capture.bin] > samples.csv\n",argv[0]);
+			return 1;
+		}	// usage
+	if (name)
+	{	// input file
+		in=fopen(name,"rb");
+		if (!in)
+		{	// no file
+			perror(name);
+			return 1;
+		}	// no file
+	}	// input file
+	
+	if (!binary)
+		printf("id,timestamp_ms,temp_iq,temp_c\n");
+	while ((size=fread(buffer,1,sizeof(buffer),in))>0)
+		decoder.write(buffer,size);
+	decoder.finish();
+	if (in!=stdin)
+		fclose(in);
+	fprintf(stderr,"frames %u, samples %u, CRC errors %u, bytes skipped %u\n",
+			decoder.getFrames(),decoder.getSamples(),decoder.getCrcErrors(),decoder.getSkipped());
+	return 0;
+}	// main
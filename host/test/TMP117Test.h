@@ -0,0 +1,51 @@
+#ifndef _TMP117_TEST_
+#define _TMP117_TEST_
+
+/* *********************************************************************
+ * minimal checks for the host test programs
+ *
+ * a failing check is reported with file and line, the program keeps
+ * running. testResult() prints the summary and returns the exit code
+ * for main.
+ * ********************************************************************* */
+
+#include <stdio.h>
+#include <stdint.h>
+
+#define CHECK(cond)			test_check((cond),#cond,__FILE__,__LINE__)
+#define CHECK_EQUAL(a,b)	test_equal((int64_t)(a),(int64_t)(b),#a,#b,__FILE__,__LINE__)
+
+static uint32_t	test_checks=0;
+static uint32_t	test_failures=0;
+
+static inline bool test_check(bool ok, const char * cond, const char * file, int line)
+{	// test_check
+	test_checks++;
+	if (!ok)
+	{	// report
+		test_failures++;
+		printf("%s:%d: check failed: %s\n",file,line,cond);
+	}	// report
+	return ok;
+}	// test_check
+
+static inline bool test_equal(	int64_t a, int64_t b, const char * name_a, const char * name_b,
+								const char * file, int line)
+{	// test_equal
+	test_checks++;
+	if (a!=b)
+	{	// report
+		test_failures++;
+		printf(	"%s:%d: check failed: %s == %s (%lld != %lld)\n",
+				file,line,name_a,name_b,(long long)a,(long long)b);
+	}	// report
+	return a==b;
+}	// test_equal
+
+static inline int testResult(const char * name)
+{	// testResult
+	printf("%s: %u checks, %u failed\n",name,(unsigned)test_checks,(unsigned)test_failures);
+	return (test_failures)?(1):(0);
+}	// testResult
+
+#endif // _TMP117_TEST_
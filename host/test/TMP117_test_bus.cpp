@@ -0,0 +1,149 @@
+/* *********************************************************************
+ * retries and bus recovery against the simulated chip
+ *
+ * NACK of a missing chip is retried without recovery, a stuck bus is
+ * recovered before the retries, the clock of the transport is restored,
+ * setters write nothing if the shadow registers cannot be loaded
+ * ********************************************************************* */
+
+// build from repository root:
+// g++ -std=c++11 -Ihost -ITMP117 host/*.cpp TMP117/*.cpp host/test/TMP117_test_bus.cpp -o TMP117_test_bus
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "TMP117Sim.h"
+#include "TMP117.h"
+#include "TMP117Trace.h"
+#include "TMP117Test.h"
+
+#define ADDRESS		0x48
+#define MISSING		0x49
+#define SDA_PIN		20
+#define SCL_PIN		21
+
+static void drain(TMP117 & sensor)
+{	// drain
+	while (!sensor.process_idle());
+}	// drain
+
+static void test_nack(void)
+{	// test_nack
+	TMP117WireTransport transport(Wire,SDA_PIN,SCL_PIN);
+	TMP117 sensor(transport,MISSING);
+	hostDrivePin(SDA_PIN,true,HIGH);			// released SDA, external pull-up
+	Wire.begin();
+	transport.setClock(400000);
+
+	CHECK(!sensor.init());
+	sensor.readTemperatureOffset();
+	CHECK(!sensor.isBusOk());
+	CHECK_EQUAL(sensor.getHealth().nacks,TMP117_RETRIES+1);
+	CHECK_EQUAL(sensor.getHealth().retries,TMP117_RETRIES);
+	CHECK_EQUAL(sensor.getHealth().failures,1);
+	CHECK_EQUAL(sensor.getHealth().recoveries,0);
+	CHECK_EQUAL(Wire.getClock(),400000);
+	hostDrivePin(SDA_PIN,false,HIGH);
+}	// test_nack
+
+static void test_stuck(void)
+{	// test_stuck
+	TMP117Sim sim(ADDRESS);
+	TMP117WireTransport transport(Wire);
+	TMP117 sensor(transport,ADDRESS);
+	uint32_t start;
+	Wire.begin();
+	transport.setClock(400000);
+	drain(sensor);
+	CHECK(sensor.init());
+	sim.setTemperature(25.0);
+	delay(sensor.getConversionCycleTime());
+	sensor.resetHealth();
+
+	// recovered after the first timeout, the retry succeeds
+	Wire.setStuck(true);
+	start=micros();
+	CHECK_EQUAL(sensor.readTemperatureOffset(),0);
+	CHECK(sensor.isBusOk());
+	CHECK((uint32_t)(micros()-start)<2*HOST_WIRE_TIMEOUT);
+	CHECK_EQUAL(sensor.getHealth().nacks,1);
+	CHECK_EQUAL(sensor.getHealth().retries,1);
+	CHECK_EQUAL(sensor.getHealth().recoveries,1);
+	CHECK_EQUAL(sensor.getHealth().failures,0);
+	// restarted TwoWire runs at the clock of the transport again
+	CHECK_EQUAL(Wire.getClock(),400000);
+	CHECK_EQUAL(sensor.getTemp(),25*128);
+
+	// a NACK afterwards is not taken for a stuck bus
+	sensor.resetHealth();
+	Wire.injectNack(1);
+	sensor.setAveragingMode(TMP117::AVERAGING_32);
+	CHECK(sensor.isBusOk());
+	CHECK_EQUAL(sensor.getHealth().nacks,1);
+	CHECK_EQUAL(sensor.getHealth().recoveries,0);
+}	// test_stuck
+
+static void fail_after_config(const uint8_t * record, uint8_t len, void * context)
+{	// fail_after_config
+	TMP117Trace::record_st rec;
+	(void)len;
+	(void)context;
+	TMP117Trace::decode(record,rec);
+	if (rec.ok && (rec.op==TMP117Trace::OP_READ) && (rec.reg==TMP117::REG_CONFIGURATION))
+		Wire.injectNack(TMP117_RETRIES+1);
+}	// fail_after_config
+
+static void test_shadow(void)
+{	// test_shadow
+	TMP117Sim sim(ADDRESS);
+	TMP117 sensor(ADDRESS);
+	uint16_t config;
+	uint16_t data;
+	uint8_t handle;
+	TMP117Trace trace(fail_after_config,NULL);
+	Wire.begin();
+	drain(sensor);
+	config=sim.getRegister(TMP117::REG_CONFIGURATION);
+
+	// factory defaults until loaded
+	Wire.injectNack(TMP117_RETRIES+1);
+	CHECK_EQUAL(sensor.getHighTemperaturLimit(),192*128);
+	CHECK(!sensor.isBusOk());
+	Wire.injectNack(TMP117_RETRIES+1);
+	CHECK_EQUAL(sensor.getLowTemperaturLimit(),INT16_MIN);
+	Wire.injectNack(TMP117_RETRIES+1);
+	CHECK_EQUAL(sensor.getAveragingMode(),TMP117::AVERAGING_8);
+
+	// shadow load fails, nothing is written
+	Wire.injectNack(TMP117_RETRIES+1);
+	sensor.setAveragingMode(TMP117::AVERAGING_64);
+	CHECK(!sensor.isBusOk());
+	CHECK_EQUAL(sim.getRegister(TMP117::REG_CONFIGURATION),config);
+	Wire.injectNack(TMP117_RETRIES+1);
+	sensor.setHighTemperaturLimit(30*128);
+	CHECK_EQUAL((int16_t)sim.getRegister(TMP117::REG_HIGH_TEMP_LIMIT),192*128);
+	// configuration read, load fails at the high limit
+	sensor.setTrace(&trace);
+	sensor.setLowTemperaturLimit(-10*128);
+	sensor.setTrace(NULL);
+	CHECK_EQUAL((int16_t)sim.getRegister(TMP117::REG_LOW_TEMP_LIMIT),INT16_MIN);
+	// no trigger, the request fails
+	Wire.injectNack(TMP117_RETRIES+1);
+	handle=sensor.requestMeasurement();
+	drain(sensor);
+	CHECK(!sensor.getTransactionResult(handle,data));
+	CHECK_EQUAL(sim.getRegister(TMP117::REG_CONFIGURATION),config);
+
+	// next setter loads the shadow and changes only its own bits
+	sensor.setAveragingMode(TMP117::AVERAGING_64);
+	CHECK(sensor.isBusOk());
+	CHECK_EQUAL(sim.getRegister(TMP117::REG_CONFIGURATION),(config&~TMP117::CONFIG_AVERAGING_MASK)|(TMP117::AVERAGING_64<<TMP117::CONFIG_AVERAGING_SHIFT));
+	CHECK_EQUAL((int16_t)sim.getRegister(TMP117::REG_HIGH_TEMP_LIMIT),192*128);
+}	// test_shadow
+
+int main(void)
+{	// main
+	test_nack();
+	test_stuck();
+	test_shadow();
+	return testResult("TMP117_test_bus");
+}	// main
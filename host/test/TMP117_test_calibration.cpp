@@ -0,0 +1,213 @@
+/* *********************************************************************
+ * calibration fit and commit against the simulated chip
+ *
+ * offset only fit for positive and negative offsets, offset added to
+ * the one in the chip, gain fit, software gain and EEPROM metadata,
+ * bus errors of commit and load, calibrated offset kept by warm start
+ * profiles
+ * ********************************************************************* */
+
+// build from repository root:
+// g++ -std=c++11 -Ihost -ITMP117 host/*.cpp TMP117/*.cpp host/test/TMP117_test_calibration.cpp -o TMP117_test_calibration
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "TMP117Sim.h"
+#include "TMP117.h"
+#include "TMP117Calibration.h"
+#include "TMP117Profile.h"
+#include "TMP117Test.h"
+
+#define ADDRESS		0x48
+#define DATE_CODE	0x2610
+
+static const int16_t offset[]={-5,-1,0,1,5,-129,200};
+
+static void drain(TMP117 & sensor)
+{	// drain
+	while (!sensor.process_idle());
+}	// drain
+
+static void test_offset(int16_t delta, int16_t chip)	// IQ9.7, reference - measured, offset in chip
+{	// test_offset
+	TMP117Sim sim(ADDRESS);
+	TMP117 sensor(ADDRESS);
+	TMP117Calibration cal(sensor);
+	int16_t measured;
+	Wire.begin();
+	drain(sensor);
+	sensor.init();
+	sensor.setEepromLockState(TMP117::EEPROM_LOCK);
+	sensor.queueWrite(TMP117::REG_TEMP_OFFSET,(uint16_t)chip);
+	drain(sensor);
+	delay(sensor.getConversionCycleTime());
+
+	measured=sensor.getTemp();
+	for (uint8_t n=0; n<3; n++)
+		cal.addPoint(measured+delta,measured);
+	CHECK(cal.compute());
+	CHECK_EQUAL(cal.getOffset(),delta);
+	CHECK_EQUAL(cal.getGain(),TMP117Calibration::GAIN_ONE);
+	CHECK(cal.commit(DATE_CODE));
+	drain(sensor);
+	CHECK_EQUAL(sensor.getEepromResult(),TMP117::EEPROM_RESULT_OK);
+	CHECK_EQUAL((int16_t)sim.getEeprom(TMP117::REG_TEMP_OFFSET),chip+delta);
+	CHECK_EQUAL(sensor.readTemperatureOffset(),chip+delta);
+	// next result includes the new offset
+	delay(sensor.getConversionCycleTime());
+	CHECK_EQUAL(sensor.getTemp(),measured+delta);
+}	// test_offset
+
+static void test_gain(void)
+{	// test_gain
+	TMP117Sim sim(ADDRESS);
+	TMP117 sensor(ADDRESS);
+	TMP117Calibration cal(sensor);
+	TMP117Calibration restored(sensor);
+	Wire.begin();
+	drain(sensor);
+	sensor.init();
+
+	// reference = 1.01 * measured - 0.25°C
+	CHECK(!cal.compute(true));
+	for (int16_t m=0; m<=6400; m+=1280)
+		cal.addPoint((int16_t)((m*101+50)/100-32),m);
+	CHECK(cal.compute(true));
+	CHECK(abs(cal.getGain()-16548)<=2);
+	CHECK(abs(cal.getOffset()+32)<=1);
+	CHECK_EQUAL(cal.apply(6400),6464);
+	CHECK_EQUAL(cal.apply(-6400),-6464);
+	CHECK(cal.commit(DATE_CODE));
+	drain(sensor);
+	CHECK_EQUAL(sensor.getEepromResult(),TMP117::EEPROM_RESULT_OK);
+
+	// all points at one temperature
+	cal.reset();
+	cal.addPoint(3200,3200);
+	cal.addPoint(3210,3200);
+	CHECK(!cal.compute(true));
+
+	CHECK(restored.load());
+	CHECK_EQUAL(restored.getGain(),cal.getGain());
+	CHECK_EQUAL(restored.getDateCode(),DATE_CODE);
+	CHECK_EQUAL(restored.getOffset(),0);
+}	// test_gain
+
+static void test_bus_error(void)
+{	// test_bus_error
+	TMP117Sim sim(ADDRESS);
+	TMP117 sensor(ADDRESS);
+	TMP117Calibration cal(sensor);
+	TMP117Calibration restored(sensor);
+	uint32_t writes;
+	Wire.begin();
+	drain(sensor);
+	sensor.init();
+	sensor.queueWrite(TMP117::REG_TEMP_OFFSET,(uint16_t)-20);
+	drain(sensor);
+
+	// offset in the chip cannot be read, nothing is programmed
+	cal.addPoint(3264,3200);
+	CHECK(cal.compute());
+	writes=sim.getEepromWriteCount();
+	Wire.injectNack(TMP117_RETRIES+1);
+	CHECK(!cal.commit(DATE_CODE));
+	drain(sensor);
+	CHECK_EQUAL(sim.getEepromWriteCount(),writes);
+	CHECK_EQUAL((int16_t)sim.getEeprom(TMP117::REG_TEMP_OFFSET),0);
+	CHECK(cal.commit(DATE_CODE));
+	drain(sensor);
+	CHECK_EQUAL((int16_t)sim.getEeprom(TMP117::REG_TEMP_OFFSET),-20+64);
+
+	// gain and date code are kept, a failed read is not an empty EEPROM
+	CHECK(restored.load());
+	Wire.injectNack(TMP117_RETRIES+1);
+	CHECK(!restored.load());
+	CHECK_EQUAL(restored.getGain(),TMP117Calibration::GAIN_ONE);
+	CHECK_EQUAL(restored.getDateCode(),DATE_CODE);
+}	// test_bus_error
+
+typedef TMP117Profile<	TMP117::MODE_CONTINUOUS,
+						TMP117::AVERAGING_32,
+						TMP117::CONVERSION_TIME_1s,
+						3000, 1000>	Room;
+typedef TMP117Profile<	TMP117::MODE_CONTINUOUS,
+						TMP117::AVERAGING_32,
+						TMP117::CONVERSION_TIME_1s,
+						3000, 1000,
+						TMP117::ALERT_MODE_ALERT,
+						TMP117::ALERT_PIN_ACTIVE_LOW,
+						TMP117::ALERT_PIN_ALERT,
+						-50>	RoomOffset;			// -0.50°C
+
+static void test_warm_start(void)
+{	// test_warm_start
+	TMP117Sim sim(ADDRESS);
+	int16_t measured;
+	const TMP117::profile_st limits={Room::CONFIG,Room::HIGH_LIMIT_IQ,Room::LOW_LIMIT_IQ,0,false};
+	uint8_t changes;
+	Wire.begin();
+	{	// calibrate
+		TMP117 sensor(ADDRESS);
+		TMP117Calibration cal(sensor);
+		drain(sensor);
+		sensor.init();
+		delay(sensor.getConversionCycleTime());
+		measured=sensor.getTemp();
+		for (uint8_t n=0; n<3; n++)
+			cal.addPoint(measured+40,measured);
+		CHECK(cal.compute());
+		CHECK(cal.commit(DATE_CODE));
+		drain(sensor);
+		CHECK_EQUAL(sensor.getEepromResult(),TMP117::EEPROM_RESULT_OK);
+	}	// calibrate
+	CHECK_EQUAL((int16_t)sim.getEeprom(TMP117::REG_TEMP_OFFSET),40);
+
+	{	// restart with persist, offset is not part of the profile
+		TMP117 sensor(ADDRESS);
+		CHECK(sensor.init(Room::profile(),changes,true));
+		CHECK(!(changes&TMP117::CHANGED_OFFSET));
+		CHECK(changes&TMP117::CHANGED_EEPROM);
+		drain(sensor);
+		CHECK_EQUAL(sensor.getEepromResult(),TMP117::EEPROM_RESULT_OK);
+		CHECK_EQUAL(sensor.readTemperatureOffset(),40);
+	}	// restart with persist
+	CHECK_EQUAL((int16_t)sim.getEeprom(TMP117::REG_TEMP_OFFSET),40);
+	CHECK_EQUAL(sim.getEeprom(TMP117::REG_CONFIGURATION),Room::CONFIG);
+
+	{	// next restart, nothing to write
+		TMP117 sensor(ADDRESS);
+		CHECK(sensor.init(Room::profile(),changes,true));
+		CHECK_EQUAL(changes,0);
+		delay(sensor.getConversionCycleTime());
+		CHECK_EQUAL(sensor.getTemp(),measured+40);
+	}	// next restart
+
+	{	// offset without writeOffset is kept too
+		TMP117 sensor(ADDRESS);
+		CHECK(sensor.init(limits,changes));
+		CHECK_EQUAL(changes,0);
+		CHECK_EQUAL(sensor.readTemperatureOffset(),40);
+	}	// offset without writeOffset
+
+	{	// explicit offset is written
+		TMP117 sensor(ADDRESS);
+		CHECK(sensor.init(RoomOffset::profile(),changes));
+		CHECK_EQUAL(changes,TMP117::CHANGED_OFFSET);
+		CHECK_EQUAL(sensor.readTemperatureOffset(),-64);
+		CHECK_EQUAL((int16_t)sim.getEeprom(TMP117::REG_TEMP_OFFSET),40);
+	}	// explicit offset
+}	// test_warm_start
+
+int main(void)
+{	// main
+	for (uint8_t n=0; n<sizeof(offset)/sizeof(offset[0]); n++)
+	{	// offsets on top of a chip offset
+		test_offset(offset[n],0);
+		test_offset(offset[n],-20);
+	}	// offsets on top of a chip offset
+	test_gain();
+	test_bus_error();
+	test_warm_start();
+	return testResult("TMP117_test_calibration");
+}	// main
@@ -0,0 +1,148 @@
+/* *********************************************************************
+ * data ready capture into TMP117SampleRing against the simulated chip
+ *
+ * one sample per conversion with the interrupt timestamp, failed reads
+ * push no sample and are repeated, overruns of a full ring
+ * ********************************************************************* */
+
+// build from repository root:
+// g++ -std=c++11 -Ihost -ITMP117 host/*.cpp TMP117/*.cpp host/test/TMP117_test_capture.cpp -o TMP117_test_capture
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "TMP117Sim.h"
+#include "TMP117.h"
+#include "TMP117SampleRing.h"
+#include "TMP117Test.h"
+
+#define ADDRESS		0x48
+#define ALERT_PIN	2
+#define RING_SIZE	16
+
+static void drain(TMP117 & sensor)
+{	// drain
+	while (!sensor.process_idle());
+}	// drain
+
+static void start(TMP117 & sensor)						// 1/8s cycle, no averaging
+{	// start
+	Wire.begin();
+	drain(sensor);
+	sensor.init();
+	sensor.beginConfig();
+	sensor.setConversionTime(TMP117::CONVERSION_TIME_1_8s);
+	sensor.setAveragingMode(TMP117::AVERAGING_OFF);
+	sensor.commitConfig();
+}	// start
+
+static void test_capture(void)
+{	// test_capture
+	TMP117Sim sim(ADDRESS);
+	TMP117 sensor(ADDRESS,ALERT_PIN);
+	TMP117::sample_st storage[RING_SIZE];
+	TMP117::sample_st sample;
+	TMP117SampleRing ring;
+	uint32_t conversions;
+	uint32_t samples=0;
+	uint32_t last=0;
+	uint8_t invalid=0;
+	sim.connectAlertPin(ALERT_PIN);
+	sim.setTemperature(21.5);
+	start(sensor);
+	CHECK(ring.begin(storage,RING_SIZE));
+	CHECK(sensor.enableDataReadyCapture(ring));
+	conversions=sim.getConversionCount();
+
+	for (uint16_t ms=0; ms<1000; ms++)
+	{	// run 1s
+		delay(1);
+		sensor.process_idle();
+		while (ring.pop(sample))
+		{	// consume
+			if (sample.temp!=21.5*128)
+				invalid++;
+			if (samples)
+				CHECK_EQUAL(sample.timestamp-last,sensor.getConversionCycleTime());
+			last=sample.timestamp;
+			samples++;
+		}	// consume
+	}	// run 1s
+	CHECK_EQUAL(invalid,0);
+	CHECK_EQUAL(samples,sim.getConversionCount()-conversions);
+	CHECK_EQUAL(sensor.getCaptureOverruns(),0);
+	CHECK_EQUAL(sensor.getCaptureFailures(),0);
+	sensor.disableDataReadyCapture();
+}	// test_capture
+
+static void test_bus_error(void)
+{	// test_bus_error
+	TMP117Sim sim(ADDRESS);
+	TMP117 sensor(ADDRESS,ALERT_PIN);
+	TMP117::sample_st storage[RING_SIZE];
+	TMP117::sample_st sample;
+	TMP117SampleRing ring;
+	uint32_t conversions;
+	uint32_t samples=0;
+	uint8_t invalid=0;
+	uint8_t failed=0;
+	sim.connectAlertPin(ALERT_PIN);
+	sim.setTemperature(-5.0);
+	start(sensor);
+	ring.begin(storage,RING_SIZE);
+	sensor.enableDataReadyCapture(ring);
+	conversions=sim.getConversionCount();
+
+	for (uint16_t ms=0; ms<1000; ms++)
+	{	// run 1s
+		delay(1);
+		if (!digitalRead(ALERT_PIN) && (failed<2))
+		{	// result pending, read fails
+			Wire.injectNack(TMP117_RETRIES+1);
+			failed++;
+		}	// result pending
+		sensor.process_idle();
+		while (ring.pop(sample))
+		{	// consume
+			if (sample.temp!=-5*128)
+				invalid++;
+			samples++;
+		}	// consume
+	}	// run 1s
+	// no INT16_MIN in the ring, the failed read was repeated
+	CHECK_EQUAL(invalid,0);
+	CHECK_EQUAL(sensor.getCaptureFailures(),2);
+	CHECK_EQUAL(samples,sim.getConversionCount()-conversions);
+	CHECK_EQUAL(sensor.getCaptureOverruns(),0);
+	sensor.disableDataReadyCapture();
+}	// test_bus_error
+
+static void test_overrun(void)
+{	// test_overrun
+	TMP117Sim sim(ADDRESS);
+	TMP117 sensor(ADDRESS,ALERT_PIN);
+	TMP117::sample_st storage[4];
+	TMP117SampleRing ring;
+	sim.connectAlertPin(ALERT_PIN);
+	start(sensor);
+	ring.begin(storage,4);
+	sensor.enableDataReadyCapture(ring);
+
+	// ring is not consumed
+	for (uint16_t ms=0; ms<1000; ms++)
+	{	// run 1s
+		delay(1);
+		sensor.process_idle();
+	}	// run 1s
+	CHECK_EQUAL(ring.available(),4);
+	CHECK(sensor.getCaptureOverruns()>=3);
+	CHECK_EQUAL(sensor.getCaptureFailures(),0);
+	sensor.disableDataReadyCapture();
+}	// test_overrun
+
+int main(void)
+{	// main
+	test_capture();
+	test_bus_error();
+	test_overrun();
+	return testResult("TMP117_test_capture");
+}	// main
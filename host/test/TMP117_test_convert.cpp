@@ -0,0 +1,196 @@
+/* *********************************************************************
+ * fixed point conversions of TMP117Convert
+ *
+ * IQ9.7 <-> decimals and the wide path for all units against an exact
+ * reference over the full int16_t range, rounding half away from zero
+ * of negative values, saturation, the sentinel passthrough and the
+ * shift selection of wide_s, scaled API of TMP117 on the simulated chip
+ * ********************************************************************* */
+
+// build from repository root:
+// g++ -std=c++11 -Ihost -ITMP117 host/*.cpp TMP117/*.cpp host/test/TMP117_test_convert.cpp -o TMP117_test_convert
+
+#include <math.h>
+#include "Arduino.h"
+#include "Wire.h"
+#include "TMP117Sim.h"
+#include "TMP117.h"
+#include "TMP117Convert.h"
+#include "TMP117Test.h"
+
+typedef TMP117Convert C;
+
+typedef struct table_s {	int16_t		in;
+							int16_t		out;
+						}	table_st;
+
+static int64_t reference(long double val)				// round half away from zero
+{	// reference
+	return llroundl(val);
+}	// reference
+
+static int16_t reference16(long double val)
+{	// reference16
+	int64_t r=reference(val);
+	return (r>INT16_MAX)?(INT16_MAX):(r<INT16_MIN)?(INT16_MIN):((int16_t)r);
+}	// reference16
+
+static int64_t reference_div(int64_t num, int64_t den)	// den>0, round half away from zero
+{	// reference_div
+	int64_t q=num/den;
+	int64_t r=num%den;
+	if (2*((r<0)?(-r):(r))>=den)
+		q+=(num<0)?(-1):(1);
+	return q;
+}	// reference_div
+
+static int64_t reference_wide(C::unit_et unit, int32_t scale, int16_t valIQ, bool delta)	// exact
+{	// reference_wide
+	// value * scale = (valIQ / 128 * factor + zero / 100) * scale
+	int64_t factor_num=(unit==C::UNIT_FAHRENHEIT)?(9):(5);
+	int64_t zero=(delta)?(0):(unit==C::UNIT_FAHRENHEIT)?(3200):(unit==C::UNIT_KELVIN)?(27315):(0);
+	return reference_div(	(int64_t)valIQ*scale*factor_num*100+zero*scale*5*128,(int64_t)128*5*100);
+}	// reference_wide
+
+template<uint8_t DECIMALS> static void test_dec(void)
+{	// test_dec
+	uint32_t errors=0;
+	for (int32_t v=INT16_MIN+1; v<INT16_MAX; v++)
+	{	// all values
+		if (C::toDec<DECIMALS>((int16_t)v)!=reference16((long double)v*C::pow10_s<DECIMALS>::value/128))
+			errors++;
+		if (C::toIQ<DECIMALS>((int16_t)v)!=reference16((long double)v*128/C::pow10_s<DECIMALS>::value))
+			errors++;
+	}	// all values
+	CHECK_EQUAL(errors,0);
+	// sentinels are passed through
+	CHECK_EQUAL(C::toDec<DECIMALS>(INT16_MIN),INT16_MIN);
+	CHECK_EQUAL(C::toDec<DECIMALS>(INT16_MAX),INT16_MAX);
+	CHECK_EQUAL(C::toIQ<DECIMALS>(INT16_MIN),INT16_MIN);
+	CHECK_EQUAL(C::toIQ<DECIMALS>(INT16_MAX),INT16_MAX);
+}	// test_dec
+
+static void test_dec_table(void)
+{	// test_dec_table
+	// halves of the last digit round away from zero, also for negative values
+	static const table_st dec0[]={{64,1},{-64,-1},{63,0},{-63,0},{192,2},{-192,-2},{-65,-1}};
+	static const table_st dec2[]={{1,1},{-1,-1},{32,25},{-32,-25},{3200,2500},{-3200,-2500},{-25600,-20000}};
+	static const table_st iq2[]={{1,1},{-1,-1},{2500,3200},{-2500,-3200},{-25599,-32767},{25599,32767}};
+	// 4 decimals saturate beyond 2.56°C
+	static const table_st dec4[]={{327,25547},{-327,-25547},{420,INT16_MAX},{-420,INT16_MIN}};
+	for (uint8_t n=0; n<sizeof(dec0)/sizeof(dec0[0]); n++)
+		CHECK_EQUAL(C::toDec<0>(dec0[n].in),dec0[n].out);
+	for (uint8_t n=0; n<sizeof(dec2)/sizeof(dec2[0]); n++)
+		CHECK_EQUAL(C::toDec<2>(dec2[n].in),dec2[n].out);
+	for (uint8_t n=0; n<sizeof(iq2)/sizeof(iq2[0]); n++)
+		CHECK_EQUAL(C::toIQ<2>(iq2[n].in),iq2[n].out);
+	for (uint8_t n=0; n<sizeof(dec4)/sizeof(dec4[0]); n++)
+		CHECK_EQUAL(C::toDec<4>(dec4[n].in),dec4[n].out);
+	// evaluated by the compiler
+	static_assert(C::toIQ<2>(-2500)==-3200,"constexpr toIQ");
+}	// test_dec_table
+
+template<C::unit_et UNIT, int32_t SCALE> static void test_wide(void)
+{	// test_wide
+	uint32_t errors=0;
+	uint32_t delta_errors=0;
+	uint32_t round_trip=0;
+	for (int32_t v=INT16_MIN+1; v<INT16_MAX; v++)
+	{	// all values
+		int32_t wide=C::toWide<UNIT,SCALE>((int16_t)v);
+		int32_t delta=C::toWideDelta<UNIT,SCALE>((int16_t)v);
+		if (wide!=reference_wide(UNIT,SCALE,(int16_t)v,false))
+			errors++;
+		if (delta!=reference_wide(UNIT,SCALE,(int16_t)v,true))
+			delta_errors++;
+		// resolution finer than IQ9.7 (1/128°C): back to the same value
+		if ((SCALE*((UNIT==C::UNIT_FAHRENHEIT)?(9):(5))>=5*128) && (	(C::fromWide<UNIT,SCALE>(wide)!=v) ||
+								(C::fromWideDelta<UNIT,SCALE>(delta)!=v)))
+			round_trip++;
+	}	// all values
+	CHECK_EQUAL(errors,0);
+	CHECK_EQUAL(delta_errors,0);
+	CHECK_EQUAL(round_trip,0);
+	// sentinels in both directions
+	CHECK_EQUAL((C::toWide<UNIT,SCALE>(INT16_MIN)),INT32_MIN);
+	CHECK_EQUAL((C::toWide<UNIT,SCALE>(INT16_MAX)),INT32_MAX);
+	CHECK_EQUAL((C::toWideDelta<UNIT,SCALE>(INT16_MIN)),INT32_MIN);
+	CHECK_EQUAL((C::fromWide<UNIT,SCALE>(INT32_MIN)),INT16_MIN);
+	CHECK_EQUAL((C::fromWide<UNIT,SCALE>(INT32_MAX)),INT16_MAX);
+	CHECK_EQUAL((C::fromWideDelta<UNIT,SCALE>(INT32_MAX)),INT16_MAX);
+	// largest shift that keeps the extreme product in int32_t
+	CHECK((C::wide_fits(	C::wide_s<UNIT,SCALE>::NUM,C::wide_s<UNIT,SCALE>::DEN,
+							C::wide_s<UNIT,SCALE>::ZERO_NUM,C::wide_s<UNIT,SCALE>::ZERO_DEN,
+							C::wide_s<UNIT,SCALE>::SHIFT)));
+	CHECK(	(C::wide_s<UNIT,SCALE>::SHIFT==24) ||
+			!(C::wide_fits(	C::wide_s<UNIT,SCALE>::NUM,C::wide_s<UNIT,SCALE>::DEN,
+							C::wide_s<UNIT,SCALE>::ZERO_NUM,C::wide_s<UNIT,SCALE>::ZERO_DEN,
+							C::wide_s<UNIT,SCALE>::SHIFT+1)));
+}	// test_wide
+
+static void test_wide_table(void)
+{	// test_wide_table
+	// -0.5 / 128 °C in milli degrees rounds away from zero
+	CHECK_EQUAL((C::toWide<C::UNIT_CELSIUS,1000>(-1)),-8);
+	CHECK_EQUAL((C::toWide<C::UNIT_CELSIUS,1000>(1)),8);
+	CHECK_EQUAL((C::toWide<C::UNIT_CELSIUS,1000000>(-1)),-7813);
+	CHECK_EQUAL((C::toWide<C::UNIT_CELSIUS,1000000>(INT16_MIN+1)),-255992188);
+	CHECK_EQUAL((C::toWide<C::UNIT_KELVIN,1000000>(INT16_MIN+1)),17157813);
+	CHECK_EQUAL((C::toWide<C::UNIT_KELVIN,1000000>(INT16_MAX-1)),529134375);
+	CHECK_EQUAL((C::toWide<C::UNIT_KELVIN,100>(0)),27315);
+	CHECK_EQUAL((C::toWide<C::UNIT_FAHRENHEIT,10>(-2048)),32);		// -16°C = 3.2°F
+	CHECK_EQUAL((C::toWideDelta<C::UNIT_KELVIN,100>(-64)),-50);
+	CHECK_EQUAL((C::fromWide<C::UNIT_CELSIUS,1>(-1)),-128);
+	CHECK_EQUAL((C::fromWide<C::UNIT_CELSIUS,1>(300)),INT16_MAX);	// saturated
+	CHECK_EQUAL((C::fromWide<C::UNIT_KELVIN,1>(0)),INT16_MIN);		// saturated
+}	// test_wide_table
+
+static void test_scaled_api(void)
+{	// test_scaled_api
+	TMP117Sim sim(0x48);
+	TMP117 sensor(0x48);
+	Wire.begin();
+	while (!sensor.process_idle());
+	sensor.init();
+	sim.setTemperature(-10.5);
+	delay(sensor.getConversionCycleTime());
+	CHECK_EQUAL(sensor.getTempScaled(),-10500);
+	CHECK_EQUAL((sensor.getTempScaled<C::UNIT_KELVIN,100>()),26265);
+	CHECK_EQUAL((sensor.getTempScaled<C::UNIT_FAHRENHEIT,10>()),131);
+
+	sensor.setTemperaturLimitsScaled<C::UNIT_FAHRENHEIT,10>(1040,-400);	// 40°C, -40°C
+	CHECK_EQUAL(sensor.getHighTemperaturLimit(),40*128);
+	CHECK_EQUAL(sensor.getLowTemperaturLimit(),-40*128);
+	CHECK_EQUAL(sensor.getLowTemperaturLimitScaled(),-40000);
+
+	// offsets without the zero point of the unit
+	CHECK((sensor.writeTemperatureOffsetScaled<C::UNIT_KELVIN,1000>(-250)));
+	while (!sensor.process_idle());
+	CHECK_EQUAL(sensor.readTemperatureOffset(),-32);
+	CHECK_EQUAL((sensor.readTemperatureOffsetScaled<C::UNIT_FAHRENHEIT,1000>()),-450);
+
+	// bus error
+	Wire.injectNack(TMP117_RETRIES+1);
+	CHECK_EQUAL(sensor.getTempScaled(),INT32_MIN);
+}	// test_scaled_api
+
+int main(void)
+{	// main
+	test_dec<0>();
+	test_dec<1>();
+	test_dec<2>();
+	test_dec<3>();
+	test_dec<4>();
+	test_dec_table();
+	test_wide<C::UNIT_CELSIUS,1>();
+	test_wide<C::UNIT_CELSIUS,1000>();
+	test_wide<C::UNIT_CELSIUS,1000000>();
+	test_wide<C::UNIT_FAHRENHEIT,100>();
+	test_wide<C::UNIT_FAHRENHEIT,1000000>();
+	test_wide<C::UNIT_KELVIN,100>();
+	test_wide<C::UNIT_KELVIN,1000>();
+	test_wide<C::UNIT_KELVIN,1000000>();
+	test_wide_table();
+	test_scaled_api();
+	return testResult("TMP117_test_convert");
+}	// main
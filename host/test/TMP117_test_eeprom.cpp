@@ -0,0 +1,144 @@
+/* *********************************************************************
+ * queued EEPROM programming against the simulated chip
+ *
+ * writeEepromSet() result, EEPROM content and lock state, bus errors
+ * during unlock, write and lock
+ * ********************************************************************* */
+
+// build from repository root:
+// g++ -std=c++11 -Ihost -ITMP117 host/*.cpp TMP117/*.cpp host/test/TMP117_test_eeprom.cpp -o TMP117_test_eeprom
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "TMP117Sim.h"
+#include "TMP117.h"
+#include "TMP117Trace.h"
+#include "TMP117Test.h"
+
+#define ADDRESS		0x48
+
+static const uint16_t value[4]={0x1234,0x5678,0xFFE0,0x9ABC};	// indexed by eeprom_pos_et
+
+typedef struct fault_s {	uint8_t		reg;		// inject after successful read of reg
+							bool		done;
+						}	fault_st;
+
+static void drain(TMP117 & sensor)
+{	// drain
+	while (!sensor.process_idle());
+}	// drain
+
+static void inject_after_read(const uint8_t * record, uint8_t len, void * context)
+{	// inject_after_read, fails all attempts of the following operation
+	fault_st * fault=(fault_st *)context;
+	TMP117Trace::record_st rec;
+	(void)len;
+	TMP117Trace::decode(record,rec);
+	if (!fault->done && rec.ok && (rec.op==TMP117Trace::OP_READ) && (rec.reg==fault->reg))
+	{	// verify read of last value done, next is the lock
+		Wire.injectNack(TMP117_RETRIES+1);
+		fault->done=true;
+	}	// verify read
+}	// inject_after_read
+
+static void test_set(void)
+{	// test_set
+	TMP117Sim sim(ADDRESS);
+	TMP117 sensor(ADDRESS);
+	Wire.begin();
+	drain(sensor);
+	sensor.init();
+
+	CHECK_EQUAL(sensor.getEepromResult(),TMP117::EEPROM_RESULT_IDLE);
+	CHECK(sensor.writeEepromSet(value));
+	CHECK_EQUAL(sensor.getEepromResult(),TMP117::EEPROM_RESULT_BUSY);
+	drain(sensor);
+	CHECK_EQUAL(sensor.getEepromResult(),TMP117::EEPROM_RESULT_OK);
+	CHECK_EQUAL(sim.getEepromWriteCount(),4);
+	CHECK_EQUAL(sim.getEeprom(TMP117::REG_EEPROM_1),value[TMP117::EEPROM_POS_1]);
+	CHECK_EQUAL(sim.getEeprom(TMP117::REG_EEPROM_2),value[TMP117::EEPROM_POS_2]);
+	CHECK_EQUAL(sim.getEeprom(TMP117::REG_TEMP_OFFSET),value[TMP117::TEMPERATURE_OFFSET]);
+	CHECK_EQUAL(sim.getEeprom(TMP117::REG_EEPROM_3),value[TMP117::EEPROM_POS_3]);
+	CHECK(sensor.testEepromLocked());
+
+	// selected values only
+	CHECK(sensor.writeEepromSet(value,1<<TMP117::EEPROM_POS_2));
+	drain(sensor);
+	CHECK_EQUAL(sensor.getEepromResult(),TMP117::EEPROM_RESULT_OK);
+	CHECK_EQUAL(sim.getEepromWriteCount(),5);
+	// unlock, values and lock need free entries
+	CHECK(!sensor.writeEepromSet(value,0));
+}	// test_set
+
+static void test_unlock_failed(void)
+{	// test_unlock_failed
+	TMP117Sim sim(ADDRESS);
+	TMP117 sensor(ADDRESS);
+	Wire.begin();
+	drain(sensor);
+	sensor.init();
+
+	CHECK(sensor.writeEepromSet(value,1<<TMP117::EEPROM_POS_1));
+	// unlock is the first bus access
+	Wire.injectNack(TMP117_RETRIES+1);
+	drain(sensor);
+	// value reached the volatile register only, read back matches
+	CHECK_EQUAL(sim.getEepromWriteCount(),0);
+	CHECK_EQUAL(sim.getRegister(TMP117::REG_EEPROM_1),value[TMP117::EEPROM_POS_1]);
+	CHECK_EQUAL(sensor.getEepromResult(),TMP117::EEPROM_RESULT_BUS_ERROR);
+}	// test_unlock_failed
+
+static void test_write_failed(void)
+{	// test_write_failed
+	TMP117Sim sim(ADDRESS);
+	TMP117 sensor(ADDRESS);
+	uint32_t start;
+	Wire.begin();
+	drain(sensor);
+	sensor.init();
+
+	CHECK(sensor.writeEepromSet(value,1<<TMP117::EEPROM_POS_1));
+	start=sim.getEepromWriteCount();
+	sensor.process_idle();					// unlock
+	Wire.injectNack(TMP117_RETRIES+1);
+	drain(sensor);
+	CHECK_EQUAL(sim.getEepromWriteCount(),start);
+	CHECK_EQUAL(sensor.getEepromResult(),TMP117::EEPROM_RESULT_BUS_ERROR);
+	CHECK(sensor.testEepromLocked());
+}	// test_write_failed
+
+static void test_lock_failed(void)
+{	// test_lock_failed
+	TMP117Sim sim(ADDRESS);
+	TMP117 sensor(ADDRESS);
+	fault_st fault={TMP117::REG_EEPROM_1,false};
+	TMP117Trace trace(inject_after_read,&fault);
+	Wire.begin();
+	drain(sensor);
+	sensor.init();
+
+	CHECK(sensor.writeEepromSet(value,1<<TMP117::EEPROM_POS_1));
+	sensor.setTrace(&trace);
+	drain(sensor);
+	sensor.setTrace(NULL);
+	CHECK(fault.done);
+	CHECK_EQUAL(sim.getEeprom(TMP117::REG_EEPROM_1),value[TMP117::EEPROM_POS_1]);
+	// value is programmed, but the EEPROM was left unlocked
+	CHECK(!sensor.testEepromLocked());
+	CHECK_EQUAL(sensor.getEepromResult(),TMP117::EEPROM_RESULT_BUS_ERROR);
+
+	// next set starts with a new result
+	CHECK(sensor.writeEepromSet(value,1<<TMP117::EEPROM_POS_2));
+	drain(sensor);
+	CHECK_EQUAL(sensor.getEepromResult(),TMP117::EEPROM_RESULT_OK);
+	CHECK(sensor.testEepromLocked());
+}	// test_lock_failed
+
+int main(void)
+{	// main
+	test_set();
+	test_unlock_failed();
+	test_write_failed();
+	test_lock_failed();
+	return testResult("TMP117_test_eeprom");
+}	// main
@@ -0,0 +1,150 @@
+/* *********************************************************************
+ * TMP117Events level thresholds against the simulated chip
+ *
+ * crossings up and down through several bands with hysteresis and
+ * debounce, limit registers moved to the enclosing levels, temperature
+ * read only after an alert of the chip
+ * ********************************************************************* */
+
+// build from repository root:
+// g++ -std=c++11 -Ihost -ITMP117 host/*.cpp TMP117/*.cpp host/test/TMP117_test_events.cpp -o TMP117_test_events
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "TMP117Sim.h"
+#include "TMP117.h"
+#include "TMP117Events.h"
+#include "TMP117Test.h"
+
+#define ADDRESS		0x48
+#define ALERT_PIN	2
+#define THRESHOLDS	4
+#define MAX_EVENTS	16
+#define STEP		64					// IQ9.7 per 1s conversion cycle, 0.5°C/s
+
+typedef struct event_s {	uint8_t					id;
+							TMP117Events::event_et	event;
+							int16_t					value;
+						}	event_st;
+
+typedef struct log_s {	event_st	event[MAX_EVENTS];
+						uint8_t		count;
+					}	log_st;
+
+typedef struct expected_s {	uint8_t					id;
+							TMP117Events::event_et	event;
+						}	expected_st;
+
+static double profile_t0;
+
+static double profile(double seconds)	// stable, up to 35°C, down to 5°C, up to 15°C, stable
+{	// profile
+	double t=seconds-profile_t0;
+	if (t<10)	return 20.0;
+	if (t<40)	return 20.0+(t-10)*0.5;
+	if (t<100)	return 35.0-(t-40)*0.5;
+	if (t<120)	return 5.0+(t-100)*0.5;
+	return 15.0;
+}	// profile
+
+static void on_event(TMP117Events & events, uint8_t id, TMP117Events::event_et event, int16_t value, void * context)
+{	// on_event
+	log_st * log=(log_st *)context;
+	(void)events;
+	if (log->count<MAX_EVENTS)
+	{	// store
+		log->event[log->count].id=id;
+		log->event[log->count].event=event;
+		log->event[log->count].value=value;
+	}	// store
+	log->count++;
+}	// on_event
+
+static void run_until(TMP117Events & events, uint32_t t0, uint32_t ms)
+{	// run_until
+	while ((millis()-t0)<ms)
+		if (events.process_idle())
+			delay(1);
+}	// run_until
+
+static void test_bands(void)
+{	// test_bands
+	TMP117Sim sim(ADDRESS);
+	TMP117 sensor(ADDRESS,ALERT_PIN);
+	TMP117Events events(sensor);
+	TMP117Events::threshold_st storage[THRESHOLDS];
+	log_st log;
+	uint8_t low;
+	uint8_t mid;
+	uint8_t high;
+	uint32_t t0;
+	uint32_t reads;
+	log.count=0;
+	sim.connectAlertPin(ALERT_PIN);
+	Wire.begin();
+	while (!sensor.process_idle());
+	profile_t0=micros()/1e6;
+	sim.setProfile(profile);
+	t0=millis();
+	sensor.init();
+	events.begin(storage,THRESHOLDS);
+	low=events.addLevel(10*128,64,1,on_event,&log);		// 10°C, 0.5°C hysteresis
+	mid=events.addLevel(25*128,64,1,on_event,&log);		// 25°C, 0.5°C hysteresis
+	high=events.addLevel(30*128,128,3,on_event,&log);	// 30°C, 1°C hysteresis, 3 samples
+
+	// first sample sets the state, limits enclose 20°C
+	run_until(events,t0,3000);
+	CHECK_EQUAL(log.count,0);
+	CHECK(events.isAbove(low));
+	CHECK(!events.isAbove(mid));
+	CHECK(!events.isTracking());
+	CHECK_EQUAL((int16_t)sim.getRegister(TMP117::REG_HIGH_TEMP_LIMIT),25*128);
+	CHECK_EQUAL((int16_t)sim.getRegister(TMP117::REG_LOW_TEMP_LIMIT),10*128-64);
+	// stable, no reads without alert
+	reads=events.getReads();
+	run_until(events,t0,10000);
+	CHECK_EQUAL(events.getReads(),reads);
+
+	// up through 25°C and 30°C, down through all three, up through 10°C
+	run_until(events,t0,110000);
+	CHECK(!events.isAbove(low));
+	CHECK_EQUAL((int16_t)sim.getRegister(TMP117::REG_HIGH_TEMP_LIMIT),10*128);
+	CHECK_EQUAL((int16_t)sim.getRegister(TMP117::REG_LOW_TEMP_LIMIT),INT16_MIN);
+	run_until(events,t0,130000);
+	reads=events.getReads();
+	run_until(events,t0,140000);
+	CHECK_EQUAL(events.getReads(),reads);
+
+	static const expected_st expected[]={	{mid,TMP117Events::EVENT_ABOVE},
+											{high,TMP117Events::EVENT_ABOVE},
+											{high,TMP117Events::EVENT_BELOW},
+											{mid,TMP117Events::EVENT_BELOW},
+											{low,TMP117Events::EVENT_BELOW},
+											{low,TMP117Events::EVENT_ABOVE}};
+	CHECK_EQUAL(log.count,sizeof(expected)/sizeof(expected[0]));
+	for (uint8_t n=0; (n<log.count) && (n<sizeof(expected)/sizeof(expected[0])); n++)
+	{	// each event
+		const TMP117Events::threshold_st & t=storage[expected[n].id];
+		int32_t boundary=(expected[n].event==TMP117Events::EVENT_ABOVE)?(t.level):(t.level-t.hysteresis);
+		int32_t distance=(expected[n].event==TMP117Events::EVENT_ABOVE)?(log.event[n].value-boundary):(boundary-log.event[n].value);
+		CHECK_EQUAL(log.event[n].id,expected[n].id);
+		CHECK_EQUAL(log.event[n].event,expected[n].event);
+		// beyond the boundary, at most debounce samples late
+		CHECK(distance>0);
+		CHECK(distance<=STEP*((t.debounce>1)?(t.debounce):(1))+STEP/8);
+	}	// each event
+
+	// limits enclose 15°C again, only alerts and debouncing were read
+	CHECK(events.isAbove(low));
+	CHECK(!events.isAbove(mid));
+	CHECK(!events.isAbove(high));
+	CHECK_EQUAL((int16_t)sim.getRegister(TMP117::REG_HIGH_TEMP_LIMIT),25*128);
+	CHECK_EQUAL((int16_t)sim.getRegister(TMP117::REG_LOW_TEMP_LIMIT),10*128-64);
+	CHECK(events.getReads()<sim.getConversionCount()/2);
+}	// test_bands
+
+int main(void)
+{	// main
+	test_bands();
+	return testResult("TMP117_test_events");
+}	// main
@@ -0,0 +1,168 @@
+/* *********************************************************************
+ * TMP117Governor against the simulated chip
+ *
+ * slow profile while stable, fast profile during a ramp, back to slow
+ * after the hold time, saved bus time against the bus traffic of the
+ * fast profile
+ * ********************************************************************* */
+
+// build from repository root:
+// g++ -std=c++11 -Ihost -ITMP117 host/*.cpp TMP117/*.cpp host/test/TMP117_test_governor.cpp -o TMP117_test_governor
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "TMP117Sim.h"
+#include "TMP117.h"
+#include "TMP117Governor.h"
+#include "TMP117Trace.h"
+#include "TMP117Test.h"
+
+#define ADDRESS		0x48
+#define CLOCK		100000
+#define RAMP_START	5.0					// s after start of the test
+#define RAMP_END	10.0				// 1°C/s
+#define RUN_MS		25000
+
+typedef struct bus_s {	uint32_t	reads;
+						uint32_t	configWrites;
+					}	bus_st;
+
+static double ramp_t0;
+
+static double ramp(double seconds)
+{	// ramp
+	double t=seconds-ramp_t0;
+	return (t<RAMP_START)?(20.0):((t<RAMP_END)?(20.0+(t-RAMP_START)):(20.0+RAMP_END-RAMP_START));
+}	// ramp
+
+static void count_bus(const uint8_t * record, uint8_t len, void * context)
+{	// count_bus
+	bus_st * bus=(bus_st *)context;
+	TMP117Trace::record_st rec;
+	(void)len;
+	TMP117Trace::decode(record,rec);
+	if (rec.op==TMP117Trace::OP_READ)
+		bus->reads++;
+	if ((rec.op==TMP117Trace::OP_WRITE) && (rec.reg==TMP117::REG_CONFIGURATION))
+		bus->configWrites++;
+}	// count_bus
+
+static void start(TMP117 & sensor)
+{	// start
+	Wire.begin();
+	while (!sensor.process_idle());
+	sensor.init();
+}	// start
+
+static void run(TMP117Governor & governor, uint32_t ms)
+{	// run
+	uint32_t end=millis()+ms;
+	while ((int32_t)(millis()-end)<0)
+		if (governor.process_idle())
+			delay(1);
+}	// run
+
+static void test_decisions(void)
+{	// test_decisions
+	TMP117Sim sim(ADDRESS);
+	TMP117 sensor(ADDRESS);
+	TMP117Governor governor(sensor);
+	bus_st bus={0,0};
+	TMP117Trace trace(count_bus,&bus);
+	const TMP117Governor::policy_st & policy=TMP117Governor::DEFAULT_POLICY;
+	int32_t fast_at=-1;					// ms after start
+	int32_t slow_at=-1;
+	int16_t max_rate=0;
+	uint32_t t0;
+	ramp_t0=micros()/1e6;
+	sim.setProfile(ramp);
+	start(sensor);
+	sensor.setTrace(&trace);
+	t0=millis();
+	governor.begin();
+	CHECK_EQUAL(governor.getProfile(),TMP117Governor::PROFILE_SLOW);
+	CHECK_EQUAL(sensor.getConversionTime(),policy.slow.time);
+	CHECK_EQUAL(sensor.getAveragingMode(),policy.slow.averaging);
+
+	while ((millis()-t0)<RUN_MS)
+	{	// run
+		TMP117Governor::profile_et before=governor.getProfile();
+		if (governor.process_idle())
+			delay(1);
+		if ((before==TMP117Governor::PROFILE_SLOW) && (governor.getProfile()==TMP117Governor::PROFILE_FAST) && (fast_at<0))
+			fast_at=millis()-t0;
+		if ((before==TMP117Governor::PROFILE_FAST) && (governor.getProfile()==TMP117Governor::PROFILE_SLOW) && (slow_at<0))
+			slow_at=millis()-t0;
+		if (governor.getRate()>max_rate)
+			max_rate=governor.getRate();
+	}	// run
+
+	// stable start is not taken for a transient, the ramp is detected
+	// within two slow windows
+	CHECK(fast_at>=RAMP_START*1000);
+	CHECK(fast_at<=RAMP_START*1000+2*policy.window+TMP117::getConversionCycleTime(policy.slow.time,policy.slow.averaging));
+	// 1°C/s is measured in the fast profile
+	CHECK(abs(max_rate-128)<=128/10);
+	// back to slow after holdWindows stable windows
+	CHECK(slow_at>=RAMP_END*1000+policy.holdWindows*policy.window);
+	CHECK(slow_at<=RAMP_END*1000+(policy.holdWindows+2)*policy.window);
+	CHECK_EQUAL(governor.getProfile(),TMP117Governor::PROFILE_SLOW);
+	CHECK_EQUAL(sensor.getConversionTime(),policy.slow.time);
+	CHECK_EQUAL(sensor.getAveragingMode(),policy.slow.averaging);
+	CHECK_EQUAL(governor.getTemp(),25*128);
+	// begin and two switches, one write each
+	CHECK_EQUAL(bus.configWrites,3);
+	sensor.setTrace(NULL);
+}	// test_decisions
+
+static void test_savings(void)
+{	// test_savings
+	TMP117Governor::policy_st fast_only=TMP117Governor::DEFAULT_POLICY;
+	uint32_t saved_reads;
+	uint32_t saved_time;
+	bus_st slow={0,0};
+	bus_st fast={0,0};
+	fast_only.slow=fast_only.fast;
+
+	{	// stable temperature, slow profile
+		TMP117Sim sim(ADDRESS);
+		TMP117 sensor(ADDRESS);
+		TMP117Governor governor(sensor);
+		TMP117Trace trace(count_bus,&slow);
+		sim.setTemperature(20.0);
+		start(sensor);
+		governor.begin();
+		sensor.setTrace(&trace);
+		run(governor,RUN_MS);
+		sensor.setTrace(NULL);
+		CHECK_EQUAL(governor.getProfile(),TMP117Governor::PROFILE_SLOW);
+		saved_reads=governor.getSavedReads();
+		saved_time=governor.getSavedBusTime(CLOCK);
+	}	// slow profile
+
+	{	// same time in the fast profile
+		TMP117Sim sim(ADDRESS);
+		TMP117 sensor(ADDRESS);
+		TMP117Governor governor(sensor);
+		TMP117Trace trace(count_bus,&fast);
+		sim.setTemperature(20.0);
+		start(sensor);
+		governor.begin(fast_only);
+		sensor.setTrace(&trace);
+		run(governor,RUN_MS);
+		sensor.setTrace(NULL);
+		CHECK_EQUAL(governor.getSavedReads(),0);
+	}	// fast profile
+
+	// data ready poll and temperature read per sample
+	uint32_t measured=(uint32_t)((uint64_t)(fast.reads-slow.reads)*TMP117::TEMP_READ_BITS*1000000UL/CLOCK);
+	CHECK(saved_reads>0);
+	CHECK(abs((int32_t)(saved_time-measured))<=(int32_t)(measured/20));
+}	// test_savings
+
+int main(void)
+{	// main
+	test_decisions();
+	test_savings();
+	return testResult("TMP117_test_governor");
+}	// main
@@ -0,0 +1,121 @@
+/* *********************************************************************
+ * history writer / reader round trip
+ *
+ * keyframes and differences over the full IQ9.7 range, values that
+ * encode like the gap escape, gaps, full buffer and corrupt data
+ * ********************************************************************* */
+
+// build from repository root:
+// g++ -std=c++11 -Ihost -ITMP117 host/*.cpp TMP117/*.cpp host/test/TMP117_test_history.cpp -o TMP117_test_history
+
+#include "Arduino.h"
+#include "TMP117History.h"
+#include "TMP117Test.h"
+
+#define INTERVAL	125
+#define START		1000
+
+static const int16_t sample[]={	128,-128,128,INT16_MAX,INT16_MIN,INT16_MAX,0,-1,1,
+								128,128,-128,INT16_MIN,INT16_MIN,256,-256,3200,3201,3199};
+static const uint8_t keyframe[]={1,2,4,64};
+
+#define SAMPLES	(sizeof(sample)/sizeof(sample[0]))
+
+static void test_round_trip(uint8_t keyframe)
+{	// test_round_trip
+	uint8_t buffer[TMP117History::HEADER_SIZE+SAMPLES*TMP117History::MAX_RECORD_SIZE];
+	int16_t temp[SAMPLES+1];
+	uint32_t timestamp[SAMPLES+1];
+	TMP117HistoryWriter writer;
+	TMP117HistoryReader reader;
+	size_t count;
+
+	CHECK(writer.begin(buffer,sizeof(buffer),INTERVAL,START,keyframe));
+	for (uint8_t n=0; n<SAMPLES; n++)
+		CHECK(writer.append(sample[n]));
+	CHECK_EQUAL(writer.getSamples(),SAMPLES);
+
+	CHECK(reader.begin(buffer,writer.getLength()));
+	CHECK_EQUAL(reader.getInterval(),INTERVAL);
+	CHECK_EQUAL(reader.getStart(),START);
+	count=reader.decode(temp,timestamp,SAMPLES+1);
+	CHECK(!reader.isError());
+	if (CHECK_EQUAL(count,SAMPLES))
+		for (uint8_t n=0; n<SAMPLES; n++)
+		{	// compare
+			CHECK_EQUAL(temp[n],sample[n]);
+			CHECK_EQUAL(timestamp[n],START+n*INTERVAL);
+		}	// compare
+}	// test_round_trip
+
+static void test_gap(void)
+{	// test_gap
+	uint8_t buffer[64];
+	int16_t temp;
+	uint32_t timestamp;
+	TMP117HistoryWriter writer;
+	TMP117HistoryReader reader;
+
+	// keyframe after the gap encodes 1.00°C (IQ 128)
+	writer.begin(buffer,sizeof(buffer),INTERVAL,START,2);
+	writer.append(100);
+	writer.skip(3);
+	writer.append(128);
+	writer.append(-128);
+	CHECK_EQUAL(writer.getSamples(),6);
+
+	reader.begin(buffer,writer.getLength());
+	CHECK(reader.next(temp,timestamp));
+	CHECK_EQUAL(temp,100);
+	CHECK_EQUAL(timestamp,START);
+	CHECK(reader.next(temp,timestamp));
+	CHECK_EQUAL(temp,128);
+	CHECK_EQUAL(timestamp,START+4*INTERVAL);
+	CHECK(reader.next(temp,timestamp));
+	CHECK_EQUAL(temp,-128);
+	CHECK_EQUAL(timestamp,START+5*INTERVAL);
+	CHECK(!reader.next(temp,timestamp));
+	CHECK(!reader.isError());
+}	// test_gap
+
+static void test_full(void)
+{	// test_full
+	uint8_t buffer[TMP117History::HEADER_SIZE+4];
+	TMP117HistoryWriter writer;
+
+	writer.begin(buffer,sizeof(buffer),INTERVAL,START,4);
+	CHECK(writer.append(INT16_MIN));		// 3 bytes
+	CHECK(writer.append(INT16_MIN));		// 1 byte
+	CHECK(!writer.append(INT16_MAX));		// 3 bytes do not fit
+	CHECK_EQUAL(writer.getSamples(),2);
+	CHECK_EQUAL(writer.getLength(),sizeof(buffer));
+}	// test_full
+
+static void test_corrupt(void)
+{	// test_corrupt
+	uint8_t buffer[32];
+	int16_t temp;
+	uint32_t timestamp;
+	TMP117HistoryWriter writer;
+	TMP117HistoryReader reader;
+
+	writer.begin(buffer,sizeof(buffer),INTERVAL,START);
+	writer.append(INT16_MAX);
+	// truncated keyframe
+	CHECK(reader.begin(buffer,writer.getLength()-1));
+	CHECK(!reader.next(temp,timestamp));
+	CHECK(reader.isError());
+	// version 1 (raw keyframes) is not read
+	buffer[2]=1;
+	CHECK(!reader.begin(buffer,writer.getLength()));
+}	// test_corrupt
+
+int main(void)
+{	// main
+	for (uint8_t n=0; n<sizeof(keyframe); n++)
+		test_round_trip(keyframe[n]);
+	test_gap();
+	test_full();
+	test_corrupt();
+	return testResult("TMP117_test_history");
+}	// main
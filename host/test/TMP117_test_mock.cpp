@@ -0,0 +1,167 @@
+/* *********************************************************************
+ * TMP117 on the mock transport
+ *
+ * built with TMP117MockTransport instead of Wire, checks the register
+ * traffic of the driver without a chip model: probe, shadow registers,
+ * batched configuration, limits, queued reads and stuck bus
+ * ********************************************************************* */
+
+// build from repository root, without the host Wire and chip model:
+// g++ -std=c++11 -DTMP117_TRANSPORT=TMP117MockTransport -DTMP117_TRANSPORT_HEADER=\"TMP117MockTransport.h\"
+//     -Ihost -ITMP117 host/Arduino.cpp TMP117/*.cpp host/test/TMP117_test_mock.cpp -o TMP117_test_mock
+
+#include "Arduino.h"
+#include "TMP117.h"
+#include "TMP117Test.h"
+
+#ifndef _TMP117_MOCK_TRANSPORT_
+#error TMP117MockTransport has to be selected as transport, see build command above
+#endif
+
+#define ADDRESS		0x48
+
+static void drain(TMP117 & sensor)
+{	// drain
+	while (!sensor.process_idle());
+}	// drain
+
+static void power_up(TMP117MockTransport & mock)	// factory defaults
+{	// power_up
+	for (uint8_t n=0; n<TMP117MockTransport::REGISTERS; n++)
+		mock.setRegister(n,0);
+	mock.setRegister(TMP117::REG_CONFIGURATION,0x0220);
+	mock.setRegister(TMP117::REG_HIGH_TEMP_LIMIT,0x6000);
+	mock.setRegister(TMP117::REG_LOW_TEMP_LIMIT,0x8000);
+	mock.setRegister(TMP117::REG_DEVICE_ID,TMP117::DEVICE_ID);
+	mock.setPresent(true);
+	mock.failNext(0);
+}	// power_up
+
+static void test_probe(void)
+{	// test_probe
+	TMP117MockTransport mock;
+	power_up(mock);
+	mock.setPresent(false);
+	{	// missing chip
+		TMP117 sensor(mock,ADDRESS);
+		CHECK(!sensor.init());
+	}	// missing chip
+	mock.setPresent(true);
+	{	// chip present, default transport is a different mock
+		TMP117 sensor(mock,ADDRESS);
+		CHECK(sensor.init());
+		CHECK_EQUAL(TMP117MockTransport::getDefault().getTransfers(),0);
+	}	// chip present
+}	// test_probe
+
+static void test_shadow(void)
+{	// test_shadow
+	TMP117MockTransport mock;
+	TMP117 sensor(mock,ADDRESS);
+	uint32_t transfers;
+	power_up(mock);
+	drain(sensor);
+	CHECK(sensor.init());
+
+	// getters are answered from the shadow
+	transfers=mock.getTransfers();
+	CHECK_EQUAL(sensor.getAveragingMode(),TMP117::AVERAGING_8);
+	CHECK_EQUAL(sensor.getConversionTime(),TMP117::CONVERSION_TIME_1s);
+	CHECK_EQUAL(sensor.getConversionMode(),TMP117::MODE_CONTINUOUS);
+	CHECK_EQUAL(sensor.getHighTemperaturLimit(),0x6000);
+	CHECK_EQUAL(sensor.getLowTemperaturLimit(),INT16_MIN);
+	CHECK_EQUAL(mock.getTransfers(),transfers);
+
+	// each setter writes the register once, status flags are not written back
+	mock.setRegister(TMP117::REG_CONFIGURATION,0x0220|TMP117::CONFIG_DATA_READY);
+	sensor.isDataReady();
+	transfers=mock.getTransfers();
+	sensor.setAveragingMode(TMP117::AVERAGING_32);
+	CHECK_EQUAL(mock.getTransfers(),transfers+1);
+	CHECK_EQUAL(mock.getRegister(TMP117::REG_CONFIGURATION),0x0240);
+	sensor.setHighTemperaturLimit(3000,2);
+	CHECK_EQUAL(mock.getRegister(TMP117::REG_HIGH_TEMP_LIMIT),3840);
+}	// test_shadow
+
+static void test_batch(void)
+{	// test_batch
+	TMP117MockTransport mock;
+	TMP117 sensor(mock,ADDRESS);
+	uint32_t transfers;
+	power_up(mock);
+	drain(sensor);
+	sensor.init();
+
+	transfers=mock.getTransfers();
+	sensor.beginConfig();
+	sensor.setAlertPinSource(TMP117::ALERT_PIN_DATA_READY);
+	sensor.setAlertPinPolarity(TMP117::ALERT_PIN_ACTIVE_HIGH);
+	sensor.setAveragingMode(TMP117::AVERAGING_OFF);
+	sensor.setConversionTime(TMP117::CONVERSION_TIME_1_8s);
+	sensor.setHighTemperaturLimit(8000,2);
+	sensor.setLowTemperaturLimit(-1000,2);
+	CHECK_EQUAL(mock.getTransfers(),transfers);
+	sensor.commitConfig();
+	// configuration and both limits, one write each
+	CHECK_EQUAL(mock.getTransfers(),transfers+3);
+	CHECK_EQUAL(mock.getRegister(TMP117::REG_CONFIGURATION),
+				TMP117::encodeConfig(	TMP117::MODE_CONTINUOUS,TMP117::AVERAGING_OFF,
+										TMP117::CONVERSION_TIME_1_8s,TMP117::ALERT_MODE_ALERT,
+										TMP117::ALERT_PIN_ACTIVE_HIGH,TMP117::ALERT_PIN_DATA_READY));
+	CHECK_EQUAL((int16_t)mock.getRegister(TMP117::REG_HIGH_TEMP_LIMIT),10240);
+	CHECK_EQUAL((int16_t)mock.getRegister(TMP117::REG_LOW_TEMP_LIMIT),-1280);
+}	// test_batch
+
+static void test_queue(void)
+{	// test_queue
+	TMP117MockTransport mock;
+	TMP117 sensor(mock,ADDRESS);
+	uint16_t data=0;
+	uint8_t handle;
+	power_up(mock);
+	drain(sensor);
+	sensor.init();
+
+	mock.setRegister(TMP117::REG_TEMPERATURE,3200);
+	handle=sensor.queueRead(TMP117::REG_TEMPERATURE);
+	drain(sensor);
+	CHECK(sensor.getTransactionResult(handle,data));
+	CHECK_EQUAL(data,3200);
+	CHECK_EQUAL(sensor.getTemp(),3200);
+	CHECK_EQUAL(sensor.getTemp(2),2500);
+}	// test_queue
+
+static void test_stuck(void)
+{	// test_stuck
+	TMP117MockTransport mock;
+	TMP117 sensor(mock,ADDRESS);
+	power_up(mock);
+	drain(sensor);
+	sensor.init();
+	mock.setRegister(TMP117::REG_TEMP_OFFSET,0xFFF0);
+
+	// failed transfer is not a stuck bus
+	sensor.resetHealth();
+	mock.failNext(TMP117_RETRIES+1);
+	sensor.readTemperatureOffset();
+	CHECK(!sensor.isBusOk());
+	CHECK_EQUAL(mock.getRecoveries(),0);
+
+	// recovered after the first attempt
+	sensor.resetHealth();
+	mock.setStuck(true);
+	CHECK_EQUAL(sensor.readTemperatureOffset(),-16);
+	CHECK_EQUAL(mock.getRecoveries(),1);
+	CHECK_EQUAL(sensor.getHealth().recoveries,1);
+	CHECK_EQUAL(sensor.getHealth().retries,1);
+}	// test_stuck
+
+int main(void)
+{	// main
+	test_probe();
+	test_shadow();
+	test_batch();
+	test_queue();
+	test_stuck();
+	return testResult("TMP117_test_mock");
+}	// main
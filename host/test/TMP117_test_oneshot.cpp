@@ -0,0 +1,221 @@
+/* *********************************************************************
+ * deadline based one-shot measurement against the simulated chip
+ *
+ * no bus access before the deadline, fresh result, failed trigger
+ * and failed read, poll long after the deadline, missed samples of
+ * TMP117DutyCycle after bus errors and with a full queue
+ * ********************************************************************* */
+
+// build from repository root:
+// g++ -std=c++11 -Ihost -ITMP117 host/*.cpp TMP117/*.cpp host/test/TMP117_test_oneshot.cpp -o TMP117_test_oneshot
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "TMP117Sim.h"
+#include "TMP117.h"
+#include "TMP117DutyCycle.h"
+#include "TMP117Test.h"
+
+#define ADDRESS		0x48
+
+typedef struct delivery_s {	uint8_t		calls;
+							bool		busOk;
+						}	delivery_st;
+
+static void deliver(TMP117 & sensor, uint8_t reg, uint16_t data, void * context)
+{	// deliver
+	delivery_st * d=(delivery_st *)context;
+	(void)reg;
+	(void)data;
+	d->calls++;
+	d->busOk=sensor.isBusOk();
+}	// deliver
+
+static void drain(TMP117 & sensor)
+{	// drain
+	while (!sensor.process_idle());
+}	// drain
+
+static void start(TMP117 & sensor)						// shut down, 32x averaging
+{	// start
+	Wire.begin();
+	drain(sensor);
+	sensor.init();
+	sensor.beginConfig();
+	sensor.setConversionMode(TMP117::MODE_SHUTDOWN);
+	sensor.setAveragingMode(TMP117::AVERAGING_32);
+	sensor.commitConfig();
+	// last result of continuous mode is not taken as one-shot result
+	delay(1000);
+}	// start
+
+static void test_measurement(void)
+{	// test_measurement
+	TMP117Sim sim(ADDRESS);
+	TMP117 sensor(ADDRESS);
+	uint16_t data=0;
+	uint8_t handle;
+	uint32_t conversions;
+	start(sensor);
+	sim.setTemperature(30.0);
+	conversions=sim.getConversionCount();
+
+	handle=sensor.requestMeasurement();
+	CHECK(handle!=TMP117::TRANSACTION_INVALID);
+	CHECK((int32_t)(sensor.getMeasurementDeadline()-millis())>=TMP117::getConversionDuration(TMP117::AVERAGING_32));
+	// no bus access until the deadline
+	Wire.resetStats();
+	while ((int32_t)(millis()-sensor.getMeasurementDeadline())<0)
+	{	// wait
+		CHECK(!sensor.process_idle());
+		delay(10);
+	}	// wait
+	CHECK_EQUAL(Wire.getTransfers(),0);
+	drain(sensor);
+	CHECK(sensor.getTransactionResult(handle,data));
+	CHECK_EQUAL(data,30*128);
+	CHECK_EQUAL(sim.getConversionCount(),conversions+1);
+	CHECK_EQUAL(sensor.getConversionMode(),TMP117::MODE_SHUTDOWN);
+}	// test_measurement
+
+static void test_trigger_failed(void)
+{	// test_trigger_failed
+	TMP117Sim sim(ADDRESS);
+	TMP117 sensor(ADDRESS);
+	delivery_st d={0,true};
+	uint16_t data;
+	uint8_t handle;
+	uint32_t conversions;
+	start(sensor);
+	conversions=sim.getConversionCount();
+
+	Wire.injectNack(TMP117_RETRIES+1);
+	handle=sensor.requestMeasurement();
+	CHECK(handle!=TMP117::TRANSACTION_INVALID);
+	// failure is reported without waiting and without reading the old result
+	CHECK_EQUAL(sensor.getMeasurementDeadline(),millis());
+	Wire.resetStats();
+	drain(sensor);
+	CHECK_EQUAL(Wire.getTransfers(),0);
+	CHECK(sensor.isTransactionDone(handle));
+	CHECK(!sensor.getTransactionResult(handle,data));
+	CHECK_EQUAL(sim.getConversionCount(),conversions);
+
+	// same for callback delivery
+	Wire.injectNack(TMP117_RETRIES+1);
+	sensor.requestMeasurement(deliver,&d);
+	drain(sensor);
+	CHECK_EQUAL(d.calls,1);
+	CHECK(!d.busOk);
+
+	// next request works
+	handle=sensor.requestMeasurement();
+	drain(sensor);
+	CHECK(sensor.getTransactionResult(handle,data));
+	CHECK_EQUAL(sim.getConversionCount(),conversions+1);
+}	// test_trigger_failed
+
+static void test_read_failed(void)
+{	// test_read_failed
+	TMP117Sim sim(ADDRESS);
+	TMP117 sensor(ADDRESS);
+	uint16_t data;
+	uint8_t handle;
+	start(sensor);
+
+	handle=sensor.requestMeasurement();
+	delay(TMP117::getMeasurementTime(TMP117::AVERAGING_32));
+	Wire.injectNack(TMP117_RETRIES+1);
+	drain(sensor);
+	CHECK(!sensor.getTransactionResult(handle,data));
+}	// test_read_failed
+
+static void test_late_poll(void)
+{	// test_late_poll
+	TMP117Sim sim(ADDRESS);
+	TMP117 sensor(ADDRESS);
+	uint16_t data=0;
+	uint8_t handle;
+	start(sensor);
+	sim.setTemperature(-8.5);
+
+	// more than half the 16 bit millis() range after the deadline
+	handle=sensor.requestMeasurement();
+	delay(40000);
+	sensor.process_idle();
+	CHECK(sensor.isTransactionDone(handle));
+	CHECK(sensor.getTransactionResult(handle,data));
+	CHECK_EQUAL((int16_t)data,-8.5*128);
+}	// test_late_poll
+
+static void test_duty_cycle(void)
+{	// test_duty_cycle
+	TMP117Sim sim(ADDRESS);
+	TMP117 sensor(ADDRESS);
+	TMP117DutyCycle duty(sensor);
+	uint32_t end;
+	Wire.begin();
+	drain(sensor);
+	sensor.init();
+
+	CHECK(duty.begin(1000,50000));
+	// first trigger fails
+	Wire.injectNack(TMP117_RETRIES+1);
+	end=millis()+5500;
+	while ((int32_t)(millis()-end)<0)
+	{	// run
+		duty.process_idle();
+		delay(1);
+	}	// run
+	CHECK_EQUAL(duty.getMissed(),1);
+	CHECK_EQUAL(duty.getSamples(),sim.getConversionCount());
+	CHECK(duty.getSamples()>=4);
+}	// test_duty_cycle
+
+static void test_duty_cycle_queue_full(void)
+{	// test_duty_cycle_queue_full
+	TMP117Sim sim(ADDRESS);
+	TMP117 sensor(ADDRESS);
+	TMP117DutyCycle duty(sensor);
+	uint8_t handle[TMP117_QUEUE_SIZE];
+	uint16_t data;
+	uint32_t end;
+	Wire.begin();
+	drain(sensor);
+	sensor.init();
+
+	CHECK(duty.begin(1000,50000));
+	// results of the application are not fetched for 2.5 intervals
+	for (uint8_t n=0; n<TMP117_QUEUE_SIZE; n++)
+		handle[n]=sensor.queueRead(TMP117::REG_DEVICE_ID);
+	drain(sensor);
+	end=millis()+2500;
+	while ((int32_t)(millis()-end)<0)
+	{	// run
+		duty.process_idle();
+		delay(1);
+	}	// run
+	CHECK_EQUAL(duty.getMissed(),3);
+	CHECK_EQUAL(duty.getSamples(),0);
+	for (uint8_t n=0; n<TMP117_QUEUE_SIZE; n++)
+		CHECK(sensor.getTransactionResult(handle[n],data));
+	end=millis()+3000;
+	while ((int32_t)(millis()-end)<0)
+	{	// run
+		duty.process_idle();
+		delay(1);
+	}	// run
+	CHECK_EQUAL(duty.getMissed(),3);
+	CHECK_EQUAL(duty.getSamples(),3);
+}	// test_duty_cycle_queue_full
+
+int main(void)
+{	// main
+	test_measurement();
+	test_trigger_failed();
+	test_read_failed();
+	test_late_poll();
+	test_duty_cycle();
+	test_duty_cycle_queue_full();
+	return testResult("TMP117_test_oneshot");
+}	// main
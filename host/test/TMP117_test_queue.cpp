@@ -0,0 +1,165 @@
+/* *********************************************************************
+ * transaction queue against the simulated chip
+ *
+ * power up wait, polled and callback results, one bus access per
+ * process_idle() call, release of internal entries and failed reads
+ * ********************************************************************* */
+
+// build from repository root:
+// g++ -std=c++11 -Ihost -ITMP117 host/*.cpp TMP117/*.cpp host/test/TMP117_test_queue.cpp -o TMP117_test_queue
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "TMP117Sim.h"
+#include "TMP117.h"
+#include "TMP117Test.h"
+
+#define ADDRESS		0x48
+
+typedef struct delivery_s {	uint8_t		calls;
+							uint8_t		reg;
+							uint16_t	data;
+						}	delivery_st;
+
+static void deliver(TMP117 & sensor, uint8_t reg, uint16_t data, void * context)
+{	// deliver
+	delivery_st * d=(delivery_st *)context;
+	(void)sensor;
+	d->calls++;
+	d->reg=reg;
+	d->data=data;
+}	// deliver
+
+static uint32_t drain(TMP117 & sensor)				// returns process_idle() calls
+{	// drain
+	uint32_t calls=1;
+	while (!sensor.process_idle())
+		calls++;
+	return calls;
+}	// drain
+
+static void test_power_up(void)
+{	// test_power_up
+	TMP117Sim sim(ADDRESS);
+	TMP117 sensor(ADDRESS);
+	Wire.begin();
+	// constructor queued the wait for the EEPROM load
+	CHECK(!sensor.process_idle());
+	drain(sensor);
+	CHECK(sensor.process_idle());
+	CHECK(sensor.init());
+}	// test_power_up
+
+static void test_polled_read(void)
+{	// test_polled_read
+	TMP117Sim sim(ADDRESS);
+	TMP117 sensor(ADDRESS);
+	uint16_t data=0;
+	uint8_t handle;
+	uint32_t transfers;
+	Wire.begin();
+	drain(sensor);
+	sensor.init();
+
+	handle=sensor.queueRead(TMP117::REG_DEVICE_ID);
+	CHECK(handle!=TMP117::TRANSACTION_INVALID);
+	CHECK(!sensor.isTransactionDone(handle));
+	// at most one bus access per call: pointer, then data
+	Wire.resetStats();
+	sensor.process_idle();
+	transfers=Wire.getTransfers();
+	CHECK(transfers<=1);
+	sensor.process_idle();
+	CHECK(Wire.getTransfers()-transfers<=1);
+	CHECK(sensor.isTransactionDone(handle));
+	CHECK(sensor.getTransactionResult(handle,data));
+	CHECK_EQUAL(data&TMP117::DEVICE_ID_MASK,TMP117::DEVICE_ID);
+	// handle is released by fetching the result
+	CHECK(!sensor.isTransactionDone(handle));
+	CHECK(!sensor.getTransactionResult(handle,data));
+}	// test_polled_read
+
+static void test_callback(void)
+{	// test_callback
+	TMP117Sim sim(ADDRESS);
+	TMP117 sensor(ADDRESS);
+	delivery_st d={0,0,0};
+	uint16_t data;
+	uint8_t handle;
+	Wire.begin();
+	drain(sensor);
+	sensor.init();
+
+	CHECK(sensor.queueWrite(TMP117::REG_HIGH_TEMP_LIMIT,0x1000,deliver,&d)!=TMP117::TRANSACTION_INVALID);
+	handle=sensor.queueRead(TMP117::REG_HIGH_TEMP_LIMIT,deliver,&d);
+	CHECK(handle!=TMP117::TRANSACTION_INVALID);
+	drain(sensor);
+	CHECK_EQUAL(d.calls,2);
+	CHECK_EQUAL(d.reg,TMP117::REG_HIGH_TEMP_LIMIT);
+	CHECK_EQUAL(d.data,0x1000);
+	CHECK_EQUAL(sim.getRegister(TMP117::REG_HIGH_TEMP_LIMIT),0x1000);
+	// results delivered by callback are not kept
+	CHECK(!sensor.getTransactionResult(handle,data));
+}	// test_callback
+
+static void test_release(void)
+{	// test_release
+	TMP117Sim sim(ADDRESS);
+	TMP117 sensor(ADDRESS);
+	uint8_t handle[TMP117_QUEUE_SIZE];
+	uint16_t data;
+	Wire.begin();
+	drain(sensor);
+	sensor.init();
+
+	// internal entries (reset wait, EEPROM) do not block the queue
+	sensor.reset();
+	drain(sensor);
+	CHECK(sensor.writeEeprom(TMP117::EEPROM_POS_1,0x1234));
+	drain(sensor);
+	CHECK_EQUAL(sensor.getEepromResult(),TMP117::EEPROM_RESULT_OK);
+	for (uint8_t n=0; n<TMP117_QUEUE_SIZE; n++)
+	{	// fill queue with polled reads
+		handle[n]=sensor.queueRead(TMP117::REG_EEPROM_1);
+		CHECK(handle[n]!=TMP117::TRANSACTION_INVALID);
+	}	// fill queue with polled reads
+	CHECK_EQUAL(sensor.queueRead(TMP117::REG_EEPROM_1),TMP117::TRANSACTION_INVALID);
+	drain(sensor);
+	// unfetched results block their entries
+	CHECK_EQUAL(sensor.queueRead(TMP117::REG_EEPROM_1),TMP117::TRANSACTION_INVALID);
+	CHECK(sensor.getTransactionResult(handle[0],data));
+	CHECK_EQUAL(data,0x1234);
+	CHECK(sensor.queueRead(TMP117::REG_EEPROM_1)!=TMP117::TRANSACTION_INVALID);
+}	// test_release
+
+static void test_failed_read(void)
+{	// test_failed_read
+	TMP117Sim sim(ADDRESS);
+	TMP117 sensor(ADDRESS);
+	uint16_t data;
+	uint8_t handle;
+	Wire.begin();
+	drain(sensor);
+	sensor.init();
+
+	handle=sensor.queueRead(TMP117::REG_DEVICE_ID);
+	Wire.injectNack(TMP117_RETRIES+1);
+	drain(sensor);
+	CHECK(sensor.isTransactionDone(handle));
+	CHECK(!sensor.getTransactionResult(handle,data));
+	CHECK(!sensor.isTransactionDone(handle));
+	// next transaction is not affected
+	handle=sensor.queueRead(TMP117::REG_DEVICE_ID);
+	drain(sensor);
+	CHECK(sensor.getTransactionResult(handle,data));
+}	// test_failed_read
+
+int main(void)
+{	// main
+	test_power_up();
+	test_polled_read();
+	test_callback();
+	test_release();
+	test_failed_read();
+	return testResult("TMP117_test_queue");
+}	// main
@@ -0,0 +1,162 @@
+/* *********************************************************************
+ * record against the simulated chip, replay with TMP117Replay
+ *
+ * the same application code runs on the chip model with TMP117Trace
+ * and on the replay: no mismatches, same samples, same EEPROM and
+ * one-shot results, NACK, failed reads and a stuck bus are reproduced
+ * ********************************************************************* */
+
+// build from repository root:
+// g++ -std=c++11 -Ihost -ITMP117 host/*.cpp TMP117/*.cpp host/test/TMP117_test_replay.cpp -o TMP117_test_replay
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "TMP117Sim.h"
+#include "TMP117Replay.h"
+#include "TMP117.h"
+#include "TMP117Trace.h"
+#include "TMP117Test.h"
+
+#define ADDRESS		0x48
+#define SAMPLES		12
+#define TRACE_SIZE	8100				// multiple of TMP117Trace::RECORD_SIZE
+
+static const uint16_t value[4]={0x1234,0x5678,0x0000,0x9ABC};	// indexed by eeprom_pos_et
+
+typedef struct result_s {	int16_t		sample[SAMPLES];
+							bool		oneShotOk;
+							uint16_t	oneShot;
+							uint8_t		eeprom;
+							uint32_t	nacks;
+							uint32_t	retries;
+							uint32_t	failures;
+						}	result_st;
+
+static void drain(TMP117 & sensor)
+{	// drain
+	while (!sensor.process_idle());
+}	// drain
+
+static void application(TMP117 & sensor, TMP117Sim * sim, result_st & result)	// faults and temperatures only with sim
+{	// application
+	uint8_t handle;
+	drain(sensor);						// power up
+	sensor.init();
+	sensor.beginConfig();
+	sensor.setConversionTime(TMP117::CONVERSION_TIME_1_8s);
+	sensor.setAveragingMode(TMP117::AVERAGING_OFF);
+	sensor.commitConfig();
+
+	for (uint8_t n=0; n<SAMPLES; n++)
+	{	// samples
+		if (sim)
+		{	// recording
+			sim->setTemperature(20.0+n*0.25);
+			if (n==3)
+				Wire.injectNack(1);						// retried
+			if (n==5)
+				Wire.injectNack(TMP117_RETRIES+1);		// sample lost
+			if (n==8)
+				Wire.setStuck(true);					// recovered
+		}	// recording
+		delay(sensor.getConversionCycleTime());
+		result.sample[n]=sensor.getTemp();
+	}	// samples
+
+	sensor.setConversionMode(TMP117::MODE_SHUTDOWN);
+	handle=sensor.requestMeasurement();
+	drain(sensor);
+	result.oneShotOk=sensor.getTransactionResult(handle,result.oneShot);
+
+	sensor.writeEepromSet(value,1<<TMP117::EEPROM_POS_1);
+	drain(sensor);
+	result.eeprom=sensor.getEepromResult();
+
+	result.nacks=sensor.getHealth().nacks;
+	result.retries=sensor.getHealth().retries;
+	result.failures=sensor.getHealth().failures;
+}	// application
+
+static void test_replay(void)
+{	// test_replay
+	static uint8_t buffer[TRACE_SIZE];
+	TMP117Trace trace(buffer,sizeof(buffer));
+	result_st recorded;
+	result_st replayed;
+
+	{	// record
+		TMP117Sim sim(ADDRESS);
+		TMP117 sensor(ADDRESS);
+		Wire.begin();
+		sensor.setTrace(&trace);
+		application(sensor,&sim,recorded);
+		sensor.setTrace(NULL);
+	}	// record
+	CHECK_EQUAL(trace.getLost(),0);
+	// faults took effect during the recording
+	CHECK_EQUAL(recorded.sample[5],INT16_MIN);
+	CHECK_EQUAL(recorded.sample[SAMPLES-1],(int16_t)((20.0+(SAMPLES-1)*0.25)*128));
+	CHECK(recorded.oneShotOk);
+	CHECK_EQUAL(recorded.eeprom,TMP117::EEPROM_RESULT_OK);
+	// one retried NACK, one lost sample, one timeout before the recovery
+	CHECK_EQUAL(recorded.nacks,1+(TMP117_RETRIES+1)+1);
+	CHECK_EQUAL(recorded.failures,1);
+
+	{	// replay, no chip model on the address
+		TMP117Replay replay(ADDRESS,trace.getBuffer(),trace.getLength());
+		TMP117 sensor(ADDRESS);
+		Wire.begin();
+		memset(&replayed,0,sizeof(replayed));
+		application(sensor,NULL,replayed);
+		CHECK_EQUAL(replay.getRecords(),trace.getRecords());
+		CHECK(replay.isFinished());
+		CHECK_EQUAL(replay.getMismatches(),0);
+	}	// replay
+
+	for (uint8_t n=0; n<SAMPLES; n++)
+		CHECK_EQUAL(replayed.sample[n],recorded.sample[n]);
+	CHECK_EQUAL(replayed.oneShotOk,recorded.oneShotOk);
+	CHECK_EQUAL(replayed.oneShot,recorded.oneShot);
+	CHECK_EQUAL(replayed.eeprom,recorded.eeprom);
+	CHECK_EQUAL(replayed.nacks,recorded.nacks);
+	CHECK_EQUAL(replayed.retries,recorded.retries);
+	CHECK_EQUAL(replayed.failures,recorded.failures);
+}	// test_replay
+
+static void configure(TMP117 & sensor, TMP117::averaging_mode_et mode)
+{	// configure
+	drain(sensor);
+	sensor.init();
+	sensor.setAveragingMode(mode);
+}	// configure
+
+static void test_mismatch(void)
+{	// test_mismatch
+	static uint8_t buffer[TRACE_SIZE];
+	TMP117Trace trace(buffer,sizeof(buffer));
+
+	{	// record
+		TMP117Sim sim(ADDRESS);
+		TMP117 sensor(ADDRESS);
+		Wire.begin();
+		sensor.setTrace(&trace);
+		configure(sensor,TMP117::AVERAGING_32);
+		sensor.setTrace(NULL);
+	}	// record
+
+	{	// different configuration write is detected
+		TMP117Replay replay(ADDRESS,trace.getBuffer(),trace.getLength());
+		TMP117 sensor(ADDRESS);
+		Wire.begin();
+		configure(sensor,TMP117::AVERAGING_64);
+		CHECK_EQUAL(replay.getMismatches(),1);
+		CHECK_EQUAL(replay.getFirstMismatch(),trace.getRecords()-1);
+	}	// different configuration
+}	// test_mismatch
+
+int main(void)
+{	// main
+	test_replay();
+	test_mismatch();
+	return testResult("TMP117_test_replay");
+}	// main
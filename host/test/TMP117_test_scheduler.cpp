@@ -0,0 +1,155 @@
+/* *********************************************************************
+ * TMP117Bus round robin scheduler against simulated chips
+ *
+ * staggered start, at most one read per process_idle(), order of the
+ * reads, resync of the conversion cycles and a sensor that vanishes
+ * ********************************************************************* */
+
+// build from repository root:
+// g++ -std=c++11 -Ihost -ITMP117 host/*.cpp TMP117/*.cpp host/test/TMP117_test_scheduler.cpp -o TMP117_test_scheduler
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "TMP117Sim.h"
+#include "TMP117.h"
+#include "TMP117Bus.h"
+#include "TMP117Trace.h"
+#include "TMP117Test.h"
+
+#define SENSORS		4
+#define ADDRESS		0x48				// sensor n at ADDRESS+n
+#define RUN_MS		10000
+#define RESYNC		4
+
+typedef struct restarts_s {	uint32_t	count[SENSORS];	// configuration writes
+						}	restarts_st;
+
+static void count_restarts(const uint8_t * record, uint8_t len, void * context)
+{	// count_restarts
+	restarts_st * restarts=(restarts_st *)context;
+	TMP117Trace::record_st rec;
+	(void)len;
+	TMP117Trace::decode(record,rec);
+	if (rec.ok && (rec.op==TMP117Trace::OP_WRITE) && (rec.reg==TMP117::REG_CONFIGURATION))
+		restarts->count[rec.address-ADDRESS]++;
+}	// count_restarts
+
+static void drain(TMP117 & sensor)
+{	// drain
+	while (!sensor.process_idle());
+}	// drain
+
+static uint8_t bits(uint8_t val)
+{	// bits
+	uint8_t n=0;
+	for (; val; val&=val-1)
+		n++;
+	return n;
+}	// bits
+
+static void test_round_robin(void)
+{	// test_round_robin
+	TMP117Sim * sim[SENSORS];
+	TMP117 * sensor[SENSORS];
+	restarts_st restarts={{0}};
+	TMP117Trace trace(count_restarts,&restarts);
+	TMP117Bus bus;
+	uint32_t reads[SENSORS]={0};
+	uint32_t last_timestamp[SENSORS]={0};
+	uint8_t last=SENSORS-2;				// last present sensor
+	uint8_t order_errors=0;
+	uint8_t multiple=0;
+	uint16_t period;
+	uint32_t end;
+
+	Wire.begin();
+	for (uint8_t n=0; n<SENSORS; n++)
+	{	// sensors
+		sim[n]=new TMP117Sim(ADDRESS+n);
+		sim[n]->setTemperature(20.0+n);
+		sensor[n]=new TMP117(ADDRESS+n);
+		drain(*sensor[n]);
+		CHECK(sensor[n]->init());
+		sensor[n]->setTrace(&trace);
+		CHECK(bus.addSensor(*sensor[n]));
+	}	// sensors
+	CHECK_EQUAL(bus.getSensorCount(),SENSORS);
+	bus.setResyncCycles(RESYNC);
+	period=sensor[0]->getConversionCycleTime();
+
+	// last sensor disappears before the start
+	delete sim[SENSORS-1];
+	sim[SENSORS-1]=NULL;
+
+	bus.start();
+	end=millis()+RUN_MS;
+	while ((int32_t)(millis()-end)<0)
+	{	// run
+		if (bus.process_idle())
+		{	// nothing due
+			delay(1);
+			continue;
+		}	// nothing due
+		uint8_t updated=bus.getUpdated();
+		if (bits(updated)>1)
+			multiple++;
+		for (uint8_t n=0; n<SENSORS; n++)
+			if (updated&(1<<n))
+			{	// new sample
+				// present sensors are read in turn, the missing one is skipped
+				if (n!=(last+1)%(SENSORS-1))
+					order_errors++;
+				last=n;
+				// one sample per period, also across a resync
+				if (reads[n])
+					CHECK(abs((int32_t)(bus.getSamples()[n].timestamp-last_timestamp[n]-period))<=1);
+				last_timestamp[n]=bus.getSamples()[n].timestamp;
+				reads[n]++;
+			}	// new sample
+	}	// run
+
+	CHECK_EQUAL(multiple,0);
+	CHECK_EQUAL(order_errors,0);
+	for (uint8_t n=0; n<SENSORS-1; n++)
+	{	// present sensors
+		// first sample one conversion after the staggered start, offset by n/SENSORS periods
+		CHECK_EQUAL(reads[n],RUN_MS/period);
+		CHECK_EQUAL(bus.getSamples()[n].temp,(20+n)*128);
+		// start and one restart per RESYNC samples
+		CHECK_EQUAL(restarts.count[n],1+reads[n]/RESYNC);
+	}	// present sensors
+	// missing sensor keeps its initial sample, the others are not delayed
+	CHECK_EQUAL(reads[SENSORS-1],0);
+	CHECK_EQUAL(bus.getSamples()[SENSORS-1].timestamp,0);
+	CHECK(!sensor[SENSORS-1]->isBusOk());
+
+	for (uint8_t n=0; n<SENSORS; n++)
+	{	// cleanup
+		delete sensor[n];
+		delete sim[n];
+	}	// cleanup
+}	// test_round_robin
+
+static void test_stop(void)
+{	// test_stop
+	TMP117Sim sim(ADDRESS);
+	TMP117 sensor(ADDRESS);
+	TMP117Bus bus;
+	Wire.begin();
+	drain(sensor);
+	sensor.init();
+	bus.addSensor(sensor);
+	bus.start();
+	// sensors are added only while stopped
+	CHECK(!bus.addSensor(sensor));
+	bus.stop();
+	CHECK_EQUAL(sensor.getConversionMode(),TMP117::MODE_SHUTDOWN);
+	CHECK(bus.process_idle());
+}	// test_stop
+
+int main(void)
+{	// main
+	test_round_robin();
+	test_stop();
+	return testResult("TMP117_test_scheduler");
+}	// main
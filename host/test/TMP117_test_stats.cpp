@@ -0,0 +1,132 @@
+/* *********************************************************************
+ * fixed point statistics of TMP117Stats
+ *
+ * mean, variance, EMA and moving average against floating point
+ * references, small deviations on top of a large mean, rounding of
+ * negative halves
+ * ********************************************************************* */
+
+// build from repository root:
+// g++ -std=c++11 -Ihost -ITMP117 host/*.cpp TMP117/*.cpp host/test/TMP117_test_stats.cpp -o TMP117_test_stats
+
+#include <math.h>
+#include <stdlib.h>
+#include "TMP117Stats.h"
+#include "TMP117Test.h"
+
+#define SAMPLES		2000
+#define WINDOW		16
+#define ALPHA		32
+
+typedef struct reference_s {	double		mean;
+								double		variance;	// sample variance
+								double		ema;
+								double		movingAverage;
+							}	reference_st;
+
+static uint32_t lcg=12345;
+
+static int16_t noise(int16_t amplitude)				// uniform in -amplitude..amplitude
+{	// noise
+	lcg=lcg*1103515245UL+12345UL;
+	return (int16_t)((lcg>>16)%(2*amplitude+1))-amplitude;
+}	// noise
+
+static reference_st reference(const int16_t * temp, uint32_t count, uint8_t alpha)	// alpha 0=256
+{	// reference
+	reference_st ref;
+	double sum=0;
+	double sq=0;
+	for (uint32_t n=0; n<count; n++)
+		sum+=temp[n];
+	ref.mean=sum/count;
+	for (uint32_t n=0; n<count; n++)
+		sq+=(temp[n]-ref.mean)*(temp[n]-ref.mean);
+	ref.variance=(count>1)?(sq/(count-1)):(0);
+	ref.ema=temp[0];
+	for (uint32_t n=1; n<count; n++)
+		ref.ema+=(temp[n]-ref.ema)*((alpha)?(alpha):(256))/256.0;
+	sum=0;
+	for (uint32_t n=(count>WINDOW)?(count-WINDOW):(0); n<count; n++)
+		sum+=temp[n];
+	ref.movingAverage=sum/((count>WINDOW)?(WINDOW):(count));
+	return ref;
+}	// reference
+
+static void check(const int16_t * temp, uint32_t count, uint8_t alpha)
+{	// check
+	int16_t window[WINDOW];
+	TMP117Stats stats;
+	reference_st ref=reference(temp,count,alpha);
+	stats.begin(window,WINDOW,alpha);
+	for (uint32_t n=0; n<count; n++)
+		stats.update(temp[n]);
+	CHECK_EQUAL(stats.getCount(),count);
+	CHECK_EQUAL(stats.getMean(),lround(ref.mean));
+	// exact for small deviations, the mean is kept with 1/4096 LSB
+	CHECK(labs((long)stats.getVariance()-lround(ref.variance))<=lround(ref.variance*1e-6));
+	CHECK(abs(stats.getStdDev()-(int16_t)sqrt(ref.variance))<=1);
+	CHECK(abs(stats.getEma()-lround(ref.ema))<=1);
+	CHECK_EQUAL(stats.getMovingAverage(),lround(ref.movingAverage));
+}	// check
+
+static void test_table(void)
+{	// test_table
+	// halves round away from zero
+	static const int16_t negative[]={-3,-4};
+	static const int16_t positive[]={3,4};
+	static const int16_t single[]={-100};
+	static const int16_t spread[]={-1280,1280,-1280,1280,0};
+	TMP117Stats stats;
+	stats.begin();
+	stats.update(-3);
+	stats.update(-4);
+	CHECK_EQUAL(stats.getMean(),-4);
+	CHECK_EQUAL(stats.getMin(),-4);
+	CHECK_EQUAL(stats.getMax(),-3);
+	CHECK_EQUAL(stats.getMovingAverage(),0);		// no window
+	check(negative,2,ALPHA);
+	check(positive,2,ALPHA);
+	check(single,1,ALPHA);
+	check(spread,5,0);								// alpha 256: EMA is the last sample
+	stats.reset();
+	CHECK_EQUAL(stats.getCount(),0);
+	CHECK_EQUAL(stats.getVariance(),0);
+}	// test_table
+
+static void test_small_deviations(void)
+{	// test_small_deviations
+	// noise of a few LSB around 25°C, the increments of m2 are small
+	static int16_t temp[SAMPLES];
+	for (int16_t amplitude=1; amplitude<=4; amplitude++)
+	{	// amplitudes
+		for (uint32_t n=0; n<SAMPLES; n++)
+			temp[n]=25*128+noise(amplitude);
+		check(temp,SAMPLES,ALPHA);
+		for (uint32_t n=0; n<SAMPLES; n++)
+			temp[n]=-40*128+noise(amplitude);
+		check(temp,SAMPLES,ALPHA);
+	}	// amplitudes
+}	// test_small_deviations
+
+static void test_wide_range(void)
+{	// test_wide_range
+	static int16_t temp[SAMPLES];
+	// ramp with noise and a step
+	for (uint32_t n=0; n<SAMPLES; n++)
+		temp[n]=(int16_t)(-20*128+n*4)+noise(64)+((n>SAMPLES/2)?(3000):(0));
+	check(temp,SAMPLES,ALPHA);
+	check(temp,SAMPLES,200);
+	// full range
+	for (uint32_t n=0; n<SAMPLES; n++)
+		temp[n]=(n&1)?(INT16_MAX):(INT16_MIN+1);
+	check(temp,SAMPLES,ALPHA);
+}	// test_wide_range
+
+int main(void)
+{	// main
+	test_table();
+	test_small_deviations();
+	test_wide_range();
+	return testResult("TMP117_test_stats");
+}	// main
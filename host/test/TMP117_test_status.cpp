@@ -0,0 +1,149 @@
+/* *********************************************************************
+ * latched status flags against the simulated chip
+ *
+ * flags are served from the latch without bus access until
+ * clearStatus(), getTemp() clears data ready, readStatus() reports a
+ * failed configuration or temperature read
+ * ********************************************************************* */
+
+// build from repository root:
+// g++ -std=c++11 -Ihost -ITMP117 host/*.cpp TMP117/*.cpp host/test/TMP117_test_status.cpp -o TMP117_test_status
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "TMP117Sim.h"
+#include "TMP117.h"
+#include "TMP117Trace.h"
+#include "TMP117Test.h"
+
+#define ADDRESS		0x48
+
+typedef struct bus_s {	uint32_t	configReads;
+						bool		failTemp;		// NACK the read after the next configuration read
+					}	bus_st;
+
+static void count_reads(const uint8_t * record, uint8_t len, void * context)
+{	// count_reads
+	bus_st * bus=(bus_st *)context;
+	TMP117Trace::record_st rec;
+	(void)len;
+	TMP117Trace::decode(record,rec);
+	if (rec.ok && (rec.op!=TMP117Trace::OP_WRITE) && (rec.reg==TMP117::REG_CONFIGURATION))
+	{	// configuration read
+		bus->configReads++;
+		if (bus->failTemp)
+		{	// next transfer fails
+			Wire.injectNack(TMP117_RETRIES+1);
+			bus->failTemp=false;
+		}	// next transfer fails
+	}	// configuration read
+}	// count_reads
+
+static void start(TMP117 & sensor)
+{	// start
+	Wire.begin();
+	while (!sensor.process_idle());
+	sensor.init();
+}	// start
+
+static void test_latch(void)
+{	// test_latch
+	TMP117Sim sim(ADDRESS);
+	TMP117 sensor(ADDRESS);
+	bus_st bus={0,false};
+	TMP117Trace trace(count_reads,&bus);
+	start(sensor);
+	sensor.setHighTemperaturLimit(25*128);
+	sim.setTemperature(30.0);
+	delay(sensor.getConversionCycleTime());
+	sensor.setTrace(&trace);
+
+	// one read latches both flags, the chip has cleared them
+	CHECK(sensor.testHighTemperatureAlert());
+	CHECK_EQUAL(bus.configReads,1);
+	CHECK(sensor.isDataReady());
+	CHECK(sensor.testHighTemperatureAlert());
+	CHECK_EQUAL(bus.configReads,1);
+	CHECK(!(sim.getRegister(TMP117::REG_CONFIGURATION)&(TMP117::CONFIG_HIGH_ALERT|TMP117::CONFIG_DATA_READY)));
+
+	// reading the result clears data ready only
+	CHECK_EQUAL(sensor.getTemp(),30*128);
+	CHECK(!sensor.isDataReady());
+	CHECK_EQUAL(bus.configReads,2);
+	CHECK(sensor.testHighTemperatureAlert());
+	CHECK_EQUAL(bus.configReads,2);
+
+	// served until cleared, even if the condition is gone
+	sim.setTemperature(20.0);
+	delay(sensor.getConversionCycleTime());
+	CHECK(sensor.testHighTemperatureAlert());
+	CHECK_EQUAL(bus.configReads,2);
+	sensor.clearStatus();
+	CHECK(!sensor.testHighTemperatureAlert());
+	CHECK_EQUAL(bus.configReads,3);
+	sensor.setTrace(NULL);
+}	// test_latch
+
+static void test_read_status(void)
+{	// test_read_status
+	TMP117Sim sim(ADDRESS);
+	TMP117 sensor(ADDRESS);
+	bus_st bus={0,false};
+	TMP117Trace trace(count_reads,&bus);
+	TMP117::status_st status;
+	start(sensor);
+	sensor.setTrace(&trace);
+	sim.setTemperature(-12.25);
+	delay(sensor.getConversionCycleTime());
+
+	status=sensor.readStatus(true);
+	CHECK(status.busOk);
+	CHECK(status.dataReady);
+	CHECK(status.tempValid);
+	CHECK_EQUAL(status.temp,-12.25*128);
+	// result has been read
+	CHECK(!sensor.isDataReady());
+
+	// no new result, no temperature read
+	status=sensor.readStatus(true);
+	CHECK(status.busOk);
+	CHECK(!status.dataReady);
+	CHECK(!status.tempValid);
+
+	// temperature read fails: not valid, data ready stays latched
+	delay(sensor.getConversionCycleTime());
+	bus.failTemp=true;
+	status=sensor.readStatus(true);
+	CHECK(!status.busOk);
+	CHECK(status.dataReady);
+	CHECK(!status.tempValid);
+	CHECK_EQUAL(status.temp,0);
+	status=sensor.readStatus(true);
+	CHECK(status.busOk);
+	CHECK(status.tempValid);
+	CHECK_EQUAL(status.temp,-12.25*128);
+
+	// configuration read fails: only the latched flags
+	sensor.setHighTemperaturLimit(-20*128);
+	delay(sensor.getConversionCycleTime());
+	sensor.clearStatus();
+	Wire.injectNack(TMP117_RETRIES+1);
+	status=sensor.readStatus(true);
+	CHECK(!status.busOk);
+	CHECK(!status.dataReady);
+	CHECK(!status.highAlert);
+	CHECK(!status.tempValid);
+	// flags were not lost on the chip
+	status=sensor.readStatus();
+	CHECK(status.busOk);
+	CHECK(status.dataReady);
+	CHECK(status.highAlert);
+	sensor.setTrace(NULL);
+}	// test_read_status
+
+int main(void)
+{	// main
+	test_latch();
+	test_read_status();
+	return testResult("TMP117_test_status");
+}	// main
@@ -0,0 +1,228 @@
+/* *********************************************************************
+ * TMP117Telemetry frames decoded with TMP117TelemetryDecoder
+ *
+ * round trip of samples, ids and timestamps over the full IQ9.7 range,
+ * output without availableForWrite() (bounded blocking write), output
+ * with little space, frames with CRC error and garbage are skipped
+ * ********************************************************************* */
+
+// build from repository root:
+// g++ -std=c++11 -Ihost -ITMP117 host/*.cpp TMP117/*.cpp host/test/TMP117_test_telemetry.cpp -o TMP117_test_telemetry
+
+#include <string.h>
+#include "Arduino.h"
+#include "TMP117Telemetry.h"
+#include "TMP117TelemetryDecoder.h"
+#include "TMP117Test.h"
+
+#define CHANNELS	2
+#define COUNT		100					// per channel, frames and a partial frame
+#define INTERVAL	15					// ms
+#define MAX_CALLS	10000				// process_idle() calls until idle
+#define CAPTURE		2048
+
+typedef struct sample_s {	uint8_t		id;
+							uint32_t	timestamp;
+							int16_t		temp;
+						}	sample_st;
+
+typedef struct log_s {	sample_st	sample[CHANNELS*COUNT];
+						uint32_t	count;
+					}	log_st;
+
+class Port : public Print
+{	// output with configurable space, forwards to the decoder
+	public:
+		Port(Print * decoder, int space) { this->decoder=decoder; this->space=space; maxWrite=0; length=0; }
+		virtual size_t write(uint8_t data) { return write(&data,1); }
+		virtual size_t write(const uint8_t * buffer, size_t size)
+		{	// write
+			if (size>maxWrite)
+				maxWrite=size;
+			for (size_t n=0; (n<size) && (length<CAPTURE); n++)
+				capture[length++]=buffer[n];
+			return (decoder)?(decoder->write(buffer,size)):(size);
+		}	// write
+		virtual int availableForWrite(void) { return space; }
+
+		Print *		decoder;
+		int			space;
+		size_t		maxWrite;					// largest write
+		uint8_t		capture[CAPTURE];
+		uint32_t	length;
+};
+
+static void log_sample(uint8_t id, uint32_t timestamp, int16_t temp, void * context)
+{	// log_sample
+	log_st * log=(log_st *)context;
+	if (log->count<CHANNELS*COUNT)
+	{	// store
+		log->sample[log->count].id=id;
+		log->sample[log->count].timestamp=timestamp;
+		log->sample[log->count].temp=temp;
+	}	// store
+	log->count++;
+}	// log_sample
+
+static int16_t sample_temp(uint8_t channel, uint32_t n)	// full range, both signs
+{	// sample_temp
+	if (n==0)	return INT16_MIN;
+	if (n==1)	return INT16_MAX;
+	if (n==2)	return -1;
+	return (int16_t)((channel?(-1):(1))*(int32_t)(n*331%32768));
+}	// sample_temp
+
+static uint32_t run(TMP117Telemetry & telemetry)	// process_idle() calls until idle
+{	// run
+	uint32_t calls=0;
+	while ((calls<MAX_CALLS) && !telemetry.process_idle())
+		calls++;
+	return calls;
+}	// run
+
+static void send(TMP117Telemetry & telemetry, TMP117Telemetry::channel_st * storage, Print & out, uint8_t writeChunk)
+{	// send
+	telemetry.begin(out,storage,CHANNELS,0,writeChunk);
+	telemetry.setId(0,0x10);
+	telemetry.setId(1,0x21);
+	for (uint32_t n=0; n<COUNT; n++)
+	{	// samples
+		for (uint8_t c=0; c<CHANNELS; c++)
+			CHECK(telemetry.add(c,sample_temp(c,n),1000+c+n*INTERVAL));
+		run(telemetry);
+	}	// samples
+	for (uint8_t c=0; c<CHANNELS; c++)
+		telemetry.flush(c);
+}	// send
+
+static void check_samples(const log_st & log)
+{	// check_samples
+	uint32_t next[CHANNELS]={0,0};
+	CHECK_EQUAL(log.count,CHANNELS*COUNT);
+	for (uint32_t n=0; (n<log.count) && (n<CHANNELS*COUNT); n++)
+	{	// each sample, in order per channel
+		uint8_t c=(log.sample[n].id==0x21)?(1):(0);
+		CHECK((log.sample[n].id==0x10) || (log.sample[n].id==0x21));
+		CHECK_EQUAL(log.sample[n].temp,sample_temp(c,next[c]));
+		CHECK_EQUAL(log.sample[n].timestamp,1000+c+next[c]*INTERVAL);
+		next[c]++;
+	}	// each sample, in order per channel
+	CHECK_EQUAL(next[0],COUNT);
+	CHECK_EQUAL(next[1],COUNT);
+}	// check_samples
+
+static void test_no_space_reported(void)
+{	// test_no_space_reported
+	// output without availableForWrite(), like the Print default
+	TMP117Telemetry telemetry;
+	TMP117Telemetry::channel_st storage[CHANNELS];
+	static log_st log;
+	TMP117TelemetryDecoder decoder(log_sample,&log);
+	Port port(&decoder,0);
+	log.count=0;
+	send(telemetry,storage,port,TMP117Telemetry::WRITE_CHUNK);
+	CHECK(run(telemetry)<MAX_CALLS);
+	decoder.finish();
+	// blocking write is bounded
+	CHECK(port.maxWrite>0);
+	CHECK(port.maxWrite<=TMP117Telemetry::WRITE_CHUNK);
+	// 6 full frames and a partial frame per channel
+	CHECK_EQUAL(telemetry.getFrames(),CHANNELS*(COUNT/TMP117Telemetry::SAMPLES+1));
+	CHECK_EQUAL(decoder.getFrames(),telemetry.getFrames());
+	CHECK_EQUAL(decoder.getCrcErrors(),0);
+	CHECK_EQUAL(decoder.getSkipped(),0);
+	CHECK_EQUAL(telemetry.getDropped(),0);
+	check_samples(log);
+}	// test_no_space_reported
+
+static void test_little_space(void)
+{	// test_little_space
+	TMP117Telemetry telemetry;
+	TMP117Telemetry::channel_st storage[CHANNELS];
+	static log_st log;
+	TMP117TelemetryDecoder decoder(log_sample,&log);
+	Port port(&decoder,3);
+	log.count=0;
+	send(telemetry,storage,port,TMP117Telemetry::WRITE_CHUNK);
+	CHECK(run(telemetry)<MAX_CALLS);
+	decoder.finish();
+	CHECK_EQUAL(port.maxWrite,3);
+	CHECK_EQUAL(decoder.getFrames(),telemetry.getFrames());
+	CHECK_EQUAL(decoder.getCrcErrors(),0);
+	check_samples(log);
+}	// test_little_space
+
+static void test_wait_for_space(void)
+{	// test_wait_for_space
+	// writeChunk 0: nothing written until the output reports space
+	TMP117Telemetry telemetry;
+	TMP117Telemetry::channel_st storage[CHANNELS];
+	static log_st log;
+	TMP117TelemetryDecoder decoder(log_sample,&log);
+	Port port(&decoder,0);
+	log.count=0;
+	telemetry.begin(port,storage,CHANNELS,0,0);
+	for (uint32_t n=0; n<TMP117Telemetry::SAMPLES; n++)
+		telemetry.add(0,sample_temp(0,n),n*INTERVAL);
+	CHECK_EQUAL(run(telemetry),MAX_CALLS);
+	CHECK_EQUAL(port.maxWrite,0);
+	port.space=64;
+	CHECK(run(telemetry)<MAX_CALLS);
+	decoder.finish();
+	CHECK_EQUAL(decoder.getFrames(),1);
+	CHECK_EQUAL(log.count,TMP117Telemetry::SAMPLES);
+}	// test_wait_for_space
+
+static void test_corrupt(void)
+{	// test_corrupt
+	TMP117Telemetry telemetry;
+	TMP117Telemetry::channel_st storage[1];
+	static log_st log;
+	Port port(NULL,64);
+	uint8_t stream[CAPTURE];
+	uint32_t length=0;
+	uint16_t frame=TMP117Telemetry::FRAME_SIZE;
+	log.count=0;
+	// three frames
+	telemetry.begin(port,storage,1);
+	for (uint32_t n=0; n<3*TMP117Telemetry::SAMPLES; n++)
+	{	// samples
+		telemetry.add(0,sample_temp(0,n),n*INTERVAL);
+		run(telemetry);
+	}	// samples
+	CHECK_EQUAL(port.length,3*frame);
+	// garbage with a false sync, frame, corrupt sample, frame, truncated frame
+	static const uint8_t garbage[]={0x00,TMP117Telemetry::SYNC_0,TMP117Telemetry::SYNC_1,0x01,0x55};
+	memcpy(&stream[length],garbage,sizeof(garbage));
+	length+=sizeof(garbage);
+	memcpy(&stream[length],port.capture,3*frame);
+	stream[length+frame+TMP117Telemetry::HEADER_SIZE+5]^=0x10;
+	length+=3*frame;
+	memcpy(&stream[length],port.capture,frame-1);
+	length+=frame-1;
+	{	// decode in small pieces
+		TMP117TelemetryDecoder decoder(log_sample,&log);
+		for (uint32_t pos=0; pos<length; pos+=7)
+			decoder.write(&stream[pos],(length-pos<7)?(length-pos):(7));
+		decoder.finish();
+		CHECK_EQUAL(decoder.getFrames(),2);
+		CHECK_EQUAL(decoder.getCrcErrors(),1);		// false sync is truncated at the end
+		CHECK_EQUAL(decoder.getSkipped(),sizeof(garbage)+frame+frame-1);
+		CHECK_EQUAL(log.count,2*TMP117Telemetry::SAMPLES);
+		for (uint32_t n=0; (n<log.count) && (n<2*TMP117Telemetry::SAMPLES); n++)
+		{	// first and third frame
+			uint32_t s=(n<TMP117Telemetry::SAMPLES)?(n):(n+TMP117Telemetry::SAMPLES);
+			CHECK_EQUAL(log.sample[n].temp,sample_temp(0,s));
+			CHECK_EQUAL(log.sample[n].timestamp,s*INTERVAL);
+		}	// first and third frame
+	}	// decode in small pieces
+}	// test_corrupt
+
+int main(void)
+{	// main
+	test_no_space_reported();
+	test_little_space();
+	test_wait_for_space();
+	test_corrupt();
+	return testResult("TMP117_test_telemetry");
+}	// main
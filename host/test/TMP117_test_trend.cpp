@@ -0,0 +1,125 @@
+/* *********************************************************************
+ * TMP117Trend forecast against the simulated chip
+ *
+ * warnings of process_idle() before the limits are crossed on a ramp,
+ * forecast crossing time, warning withdrawn when the ramp stops
+ * ********************************************************************* */
+
+// build from repository root:
+// g++ -std=c++11 -Ihost -ITMP117 host/*.cpp TMP117/*.cpp host/test/TMP117_test_trend.cpp -o TMP117_test_trend
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "TMP117Sim.h"
+#include "TMP117.h"
+#include "TMP117Trend.h"
+#include "TMP117Test.h"
+
+#define ADDRESS		0x48
+#define MAX_WARNINGS	8
+#define HIGH_LIMIT	(30*128)
+#define LOW_LIMIT	(10*128)
+#define LOW_CROSSING	76000			// ms, ramp down reaches 10°C
+
+typedef struct warning_s {	TMP117Trend::warning_et	warning;
+							uint32_t				crossingMs;
+							uint32_t				time;		// ms after start
+						}	warning_st;
+
+typedef struct log_s {	warning_st	warning[MAX_WARNINGS];
+						uint8_t		count;
+						uint32_t	t0;
+					}	log_st;
+
+static double profile_t0;
+
+static double profile(double seconds)	// up at 0.5°C/s, stop 2°C below the high limit, down through the low limit
+{	// profile
+	double t=seconds-profile_t0;
+	if (t<10)	return 20.0;
+	if (t<26)	return 20.0+(t-10)*0.5;
+	if (t<40)	return 28.0;
+	if (t<86)	return 28.0-(t-40)*0.5;
+	return 5.0;
+}	// profile
+
+static void on_warning(TMP117Trend & trend, TMP117Trend::warning_et warning, uint32_t crossingMs, void * context)
+{	// on_warning
+	log_st * log=(log_st *)context;
+	(void)trend;
+	if (log->count<MAX_WARNINGS)
+	{	// store
+		log->warning[log->count].warning=warning;
+		log->warning[log->count].crossingMs=crossingMs;
+		log->warning[log->count].time=millis()-log->t0;
+	}	// store
+	log->count++;
+}	// on_warning
+
+static void run_until(TMP117Trend & trend, uint32_t t0, uint32_t ms)
+{	// run_until
+	while ((millis()-t0)<ms)
+		if (trend.process_idle())
+			delay(1);
+}	// run_until
+
+static void test_forecast(void)
+{	// test_forecast
+	TMP117Sim sim(ADDRESS);
+	TMP117 sensor(ADDRESS);
+	TMP117Trend trend(sensor);
+	const TMP117Trend::config_st & config=TMP117Trend::DEFAULT_CONFIG;
+	log_st log;
+	uint32_t t0;
+	log.count=0;
+	Wire.begin();
+	while (!sensor.process_idle());
+	sensor.init();
+	sensor.setHighTemperaturLimit(HIGH_LIMIT);
+	sensor.setLowTemperaturLimit(LOW_LIMIT);
+	profile_t0=micros()/1e6;
+	sim.setProfile(profile);
+	t0=millis();
+	log.t0=t0;
+	trend.begin(on_warning,&log);
+
+	// stable, no forecast
+	run_until(trend,t0,10000);
+	CHECK_EQUAL(log.count,0);
+	CHECK(trend.getSamples()>=9);
+	CHECK_EQUAL(trend.predictedCrossingMs(),TMP117Trend::NO_CROSSING);
+
+	// ramp up, 30°C would be reached at 30s
+	run_until(trend,t0,25000);
+	// 0.5°C/s, trend smoothing still converging
+	CHECK(abs(trend.getTrend()-64)<=64/4);
+	CHECK_EQUAL(trend.getWarning(),TMP117Trend::WARNING_HIGH);
+	// ramp stops below the limit, warning withdrawn
+	run_until(trend,t0,40000);
+	CHECK_EQUAL(trend.getWarning(),TMP117Trend::WARNING_NONE);
+	// ramp down, warning before the chip flags the low limit
+	run_until(trend,t0,LOW_CROSSING);
+	CHECK_EQUAL(trend.getWarning(),TMP117Trend::WARNING_LOW);
+	CHECK(abs(trend.getTrend()+64)<=64/4);
+
+	CHECK_EQUAL(log.count,3);
+	CHECK_EQUAL(log.warning[0].warning,TMP117Trend::WARNING_HIGH);
+	CHECK_EQUAL(log.warning[1].warning,TMP117Trend::WARNING_NONE);
+	CHECK_EQUAL(log.warning[2].warning,TMP117Trend::WARNING_LOW);
+	// high: within the lead time of the crossing the ramp would have reached
+	CHECK(log.warning[0].crossingMs<=config.lead);
+	CHECK(log.warning[0].time>=20000);
+	CHECK(log.warning[0].time<26000);
+	CHECK(log.warning[1].time>=26000);
+	CHECK(log.warning[1].crossingMs>config.lead);
+	// low: forecast close to the actual crossing, some seconds ahead of it
+	CHECK(log.warning[2].crossingMs<=config.lead);
+	CHECK(log.warning[2].time+5000<=LOW_CROSSING);
+	CHECK(abs((int32_t)(log.warning[2].time+log.warning[2].crossingMs)-LOW_CROSSING)<=3000);
+}	// test_forecast
+
+int main(void)
+{	// main
+	test_forecast();
+	return testResult("TMP117_test_trend");
+}	// main
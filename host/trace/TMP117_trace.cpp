@@ -0,0 +1,79 @@
+/* *********************************************************************
+ * decoder of TMP117Trace recordings
+ *
+ * reads a binary trace (RAM dump or serial capture), writes the records
+ * as CSV to stdout and a summary of the bus usage to stderr. Timestamps
+ * are unwrapped and relative to the first record.
+ * ********************************************************************* */
+
+// build from repository root:
+// g++ -std=c++11 -ITMP117 TMP117/TMP117Trace.cpp host/trace/TMP117_trace.cpp -o TMP117_trace
+
+#include <stdio.h>
+#include "TMP117Trace.h"
+
+#define OPS		5
+
+static const char * const op_name[OPS]={"pointer","read_data","read","write","probe"};
+static const uint8_t op_bits[OPS]={20,29,49,38,11};	// start, bytes with ack, stop
+
+int main(int argc, char ** argv)
+{	// main
+	static const uint32_t clock[]={100000,400000,1000000};
+	uint8_t raw[TMP117Trace::RECORD_SIZE];
+	TMP117Trace::record_st rec;
+	uint32_t count[OPS]={0};
+	uint32_t records=0;
+	uint32_t failures=0;
+	uint64_t bits=0;
+	uint64_t first=0;
+	uint64_t time=0;
+	uint64_t epoch=0;
+	uint32_t last=0;
+	FILE * file;
+	
+	if (argc!=2)
+	{	// usage
+		fprintf(stderr,"usage: %s trace.bin > trace.csv\n",argv[0]);
+		return 1;
+	}	// usage
+	file=fopen(argv[1],"rb");
+	if (!file)
+	{	// no file
+		perror(argv[1]);
+		return 1;
+	}	// no file
+	
+	printf("time_us,address,register,operation,ok,data\n");
+	while (fread(raw,1,sizeof(raw),file)==sizeof(raw))
+	{	// records
+		TMP117Trace::decode(raw,rec);
+		if (records && (rec.timestamp<last))
+			epoch+=(uint64_t)1<<32;
+		last=rec.timestamp;
+		time=epoch+rec.timestamp;
+		if (!records)
+			first=time;
+		records++;
+		if (!rec.ok)
+			failures++;
+		if (rec.op<OPS)
+		{	// known operation
+			count[rec.op]++;
+			// a failed attempt ends after the address
+			bits+=(rec.ok)?(op_bits[rec.op]):(op_bits[TMP117Trace::OP_PROBE]);
+		}	// known operation
+		printf(	"%llu,0x%02X,0x%02X,%s,%u,0x%04X\n",(unsigned long long)(time-first),rec.address,rec.reg,
+				(rec.op<OPS)?(op_name[rec.op]):("?"),rec.ok,rec.data);
+	}	// records
+	fclose(file);
+	
+	fprintf(stderr,"records %u, failed %u, span %.3f s\n",records,failures,(time-first)/1e6);
+	for (uint8_t op=0; op<OPS; op++)
+		fprintf(stderr,"%-10s %u\n",op_name[op],count[op]);
+	fprintf(stderr,"bus clocks %llu",(unsigned long long)bits);
+	for (uint8_t c=0; c<sizeof(clock)/sizeof(clock[0]); c++)
+		fprintf(stderr,", %.1f ms at %u kHz",bits*1e3/clock[c],clock[c]/1000);
+	fprintf(stderr,"\n");
+	return 0;
+}	// main